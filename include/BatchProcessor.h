@@ -0,0 +1,92 @@
+// include/BatchProcessor.h
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ObjectDetector.h"
+#include "ObjectDistanceDetector.h"
+
+// 일괄 처리 결과를 열 단위로 모은 표. 한 행이 탐지 하나이며, 같은 열의 값이 연속으로 저장되어
+// 파일이 작고 분석 도구에서 열 하나만 읽기 쉽다.
+struct DetectionTable {
+    std::vector<uint32_t> frame;        // 프레임 번호 (매니페스트의 행 번호)
+    std::vector<uint16_t> classId;
+    std::vector<float> confidence;
+    std::vector<int32_t> x;
+    std::vector<int32_t> y;
+    std::vector<int32_t> width;
+    std::vector<int32_t> height;
+    std::vector<float> distanceCm;      // 거리를 추정할 수 없는 클래스는 NaN
+
+    size_t size() const { return frame.size(); }
+
+    void append(uint32_t frameIndex, const Detection& detection, float distance);
+    void append(const DetectionTable& other);
+
+    // 프레임 번호 순으로 정렬 (같은 프레임 안의 순서는 유지)
+    void sortByFrame();
+
+    // 파일 형식: 헤더 (magic "DPDETCOL", uint32 버전, uint32 열 개수, uint64 행 개수) 뒤에
+    // 위 선언 순서대로 각 열의 값을 연속으로 기록 (호스트 바이트 순서)
+    void save(const std::string& path) const;
+    static DetectionTable load(const std::string& path);
+};
+
+// 프레임 번호 -> 원본 위치
+struct BatchSource {
+    std::string path;
+    int64_t sourceFrame = 0;    // 동영상의 프레임 번호 (이미지 파일은 0)
+};
+
+struct BatchOptions {
+    int workers = 0;                // 탐지 스레드 수 (0이면 하드웨어 스레드 수)
+    int decoders = 2;               // 디코딩 스레드 수
+    int queueCapacity = 32;         // 디코딩되어 탐지를 기다리는 최대 프레임 수
+    std::string overlayDir;         // 비어 있지 않으면 결과 오버레이 이미지를 비동기로 저장
+    int overlayQueueCapacity = 16;  // 저장을 기다리는 최대 오버레이 수
+};
+
+struct BatchStats {
+    uint64_t frames = 0;            // 탐지한 프레임 수
+    uint64_t detections = 0;
+    uint64_t stolenFrames = 0;      // 다른 작업자의 큐에서 가져와 처리한 프레임 수
+    uint64_t decodeFailures = 0;    // 읽지 못한 이미지/프레임 수
+    uint64_t overlaysWritten = 0;
+    double elapsedMs = 0.0;
+
+    double fps() const { return elapsedMs > 0.0 ? frames * 1000.0 / elapsedMs : 0.0; }
+};
+
+// 이미지 디렉터리나 동영상을 여러 스레드로 디코딩하고, 작업자마다 ObjectDetector 인스턴스를 두어
+// 프레임 단위로 병렬 탐지한다. 디코더는 작업자별 큐에 프레임을 번갈아 넣고, 자기 큐가 빈 작업자는
+// 다른 작업자 큐의 뒤쪽에서 프레임을 가져와(work stealing) 처리 시간이 고르지 않아도 코어가 놀지 않는다.
+class BatchProcessor {
+public:
+    using DetectorFactory = std::function<std::unique_ptr<ObjectDetector>()>;
+
+    explicit BatchProcessor(DetectorFactory factory, const BatchOptions& options = BatchOptions());
+
+    // input: 이미지 파일이 들어 있는 디렉터리 또는 동영상 파일. 결과는 프레임 번호 순으로 정렬됨
+    DetectionTable run(const std::string& input);
+
+    // 마지막 run()의 프레임 번호별 원본 위치
+    const std::vector<BatchSource>& getSources() const { return sources; }
+    // CSV (frame,source,source_frame)로 저장
+    void saveManifest(const std::string& path) const;
+
+    const BatchStats& getStats() const { return stats; }
+    std::string report() const;
+
+private:
+    DetectorFactory factory;
+    BatchOptions options;
+    std::vector<BatchSource> sources;
+    BatchStats stats;
+};
+
+#endif // BATCH_PROCESSOR_H
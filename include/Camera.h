@@ -3,20 +3,30 @@
 #define CAMERA_H
 
 #include <opencv2/opencv.hpp>
+#include <cstdint>
 #include <string>
+#include "Frame.h"
 
 enum class CameraType {
     WEBCAM,
-    CSI
+    CSI,
+    REPLAY  // 녹화된 영상 또는 이미지 시퀀스 재생
 };
 
 class Camera {
 public:
     explicit Camera(int deviceID = 0, CameraType type = CameraType::WEBCAM);
+    // 영상 파일 또는 이미지 시퀀스 패턴(예: "frame_%03d.png")을 재생
+    explicit Camera(const std::string& source);
     cv::Mat getFrame();
+    // 호출자가 준비한 버퍼(예: 공유 메모리 슬롯)에 직접 프레임을 읽음
+    bool getFrame(cv::Mat& frame);
+    // 프레임을 읽어 순번과 캡처 시각이 담긴 봉투로 반환 (frame.image의 버퍼가 있으면 재사용)
+    bool capture(FrameEnvelope& frame);
 private:
     cv::VideoCapture cap;
     CameraType cameraType;
+    uint64_t sequence = 0;
     std::string gstreamerPipeline(int capture_width, int capture_height, int display_width, int display_height, int framerate, int flip_method);
 };
 
@@ -0,0 +1,61 @@
+// include/CascadeDetector.h
+#ifndef CASCADE_DETECTOR_H
+#define CASCADE_DETECTOR_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ObjectDetector.h"
+
+// 캐스케이드 설정
+struct CascadeOptions {
+    float candidateThreshold = 0.25f;  // 작은 모델이 후보로 내보내는 최소 confidence
+    float acceptThreshold = 0.6f;      // 이 이상이면 작은 모델 결과를 그대로 채택
+    float largeThreshold = 0.5f;       // 큰 모델의 confidence 임계값
+    float nmsThreshold = 0.4f;
+    float ambiguityIoU = 0.3f;         // 클래스가 다른 두 박스가 이만큼 겹치면 애매한 것으로 판단
+    float contextMargin = 0.5f;        // 크롭할 때 박스 크기 대비 주변 여유 비율
+    int minCropSize = 160;             // 크롭 최소 크기 (px)
+    int maxRegions = 4;                // 재검사 영역이 이보다 많으면 큰 모델을 전체 프레임에 한 번 실행
+};
+
+// 캐스케이드 누적 통계
+struct CascadeStats {
+    uint64_t frames = 0;                 // 처리한 프레임 수
+    uint64_t escalatedFrames = 0;        // 큰 모델을 실행한 프레임 수
+    uint64_t escalatedRegions = 0;       // 큰 모델로 재검사한 크롭 수
+    uint64_t fullFrameEscalations = 0;   // 영역이 많아 전체 프레임으로 재검사한 횟수
+    uint64_t uncertainDetections = 0;    // 재검사 대상이 된 작은 모델 탐지 수
+    uint64_t confirmedDetections = 0;    // 그중 큰 모델이 확인한 수
+
+    double escalationRate() const { return frames > 0 ? static_cast<double>(escalatedFrames) / frames : 0.0; }
+};
+
+// 두 단계 캐스케이드 탐지기. 가벼운 모델을 전체 프레임에 실행하고, confidence가 낮거나
+// 클래스가 애매한 탐지만 주변 영역을 잘라 무거운 모델로 다시 확인한 뒤 하나의 결과로 합친다.
+class CascadeDetector {
+public:
+    CascadeDetector(std::unique_ptr<ObjectDetector> smallDetector, std::unique_ptr<ObjectDetector> largeDetector, const CascadeOptions& options = CascadeOptions());
+
+    // 모델 경로로 생성 (작은 모델은 candidateThreshold, 큰 모델은 largeThreshold로 로드)
+    CascadeDetector(const std::string& smallModelPath, const std::string& largeModelPath, const std::string& classNamesPath, const CascadeOptions& options = CascadeOptions());
+
+    std::vector<Detection> detect(const cv::Mat& frame);
+
+    const CascadeStats& getStats() const { return stats; }
+    const std::vector<std::string>& getClassNames() const { return smallDetector->getClassNames(); }
+    std::string report() const;
+
+private:
+    std::unique_ptr<ObjectDetector> smallDetector;
+    std::unique_ptr<ObjectDetector> largeDetector;
+    CascadeOptions options;
+    CascadeStats stats;
+
+    // 재검사할 탐지들을 덮는 크롭 영역 (겹치는 영역은 하나로 합침)
+    std::vector<cv::Rect> escalationRegions(const std::vector<Detection>& uncertain, const cv::Size& frameSize) const;
+};
+
+#endif // CASCADE_DETECTOR_H
@@ -0,0 +1,70 @@
+// include/Frame.h
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "PipelineStage.h"  // PipelineStage, monotonicNowNs
+
+// 캡처부터 거리 추정까지 프레임과 함께 전달되는 봉투
+struct FrameEnvelope {
+    cv::Mat image;
+    uint64_t sequence = 0;       // 캡처 순번
+    int64_t captureTimeNs = 0;   // 캡처 시각 (monotonicNowNs 기준)
+
+    // 단계별 시작/종료 시각 (0이면 아직 실행되지 않음)
+    std::array<int64_t, PIPELINE_STAGE_COUNT> stageStartNs{};
+    std::array<int64_t, PIPELINE_STAGE_COUNT> stageEndNs{};
+
+    // 마감 시간을 넘겨 버려진 프레임인지, 어느 단계에서 버려졌는지
+    bool dropped = false;
+    PipelineStage droppedAt = PipelineStage::CAPTURE;
+
+    // 이미지 버퍼는 다음 캡처에서 재사용하도록 남기고 순번, 시각, 버림 표시만 초기화.
+    // 버퍼를 다른 단계와 공유하는 중이면 덮어쓰게 되므로 넘겨준 뒤에는 image를 비워(move) 둘 것
+    void reset() {
+        cv::Mat buffer = std::move(image);
+        *this = FrameEnvelope();
+        image = std::move(buffer);
+    }
+
+    void beginStage(PipelineStage stage) { stageStartNs[static_cast<int>(stage)] = monotonicNowNs(); }
+    void endStage(PipelineStage stage) { stageEndNs[static_cast<int>(stage)] = monotonicNowNs(); }
+
+    // 캡처 이후 경과 시간
+    int64_t ageNs() const { return monotonicNowNs() - captureTimeNs; }
+    double ageMs() const { return ageNs() / 1e6; }
+    // 단계 소요 시간 (실행되지 않았으면 0)
+    double stageMs(PipelineStage stage) const {
+        int i = static_cast<int>(stage);
+        return stageEndNs[i] > stageStartNs[i] ? (stageEndNs[i] - stageStartNs[i]) / 1e6 : 0.0;
+    }
+};
+
+// 단계별 마감 시간. 각 단계는 시작 전에 admit()을 호출하고, 프레임의 나이(캡처 이후 경과 시간)가
+// 해당 단계의 마감 시간을 넘겼으면 처리하지 않고 버린다. 이미 늦은 프레임에 연산을 쓰지 않기 위함.
+class StageDeadlines {
+public:
+    StageDeadlines() = default;  // 마감 시간 없음
+    // 설정 파일의 deadlines_ms 항목에서 읽음 (예: deadlines_ms: { inference: 50, postprocess: 80 })
+    explicit StageDeadlines(const std::string& configPath);
+
+    // 마감 시간 설정 (0 이하면 해제)
+    void set(PipelineStage stage, double deadlineMs);
+    double get(PipelineStage stage) const;
+
+    // 마감 전이면 true, 지났으면 프레임을 dropped로 표시하고 false.
+    // 단계 시작 시각은 아직 기록되지 않은 경우에만 기록하므로 호출자가 미리 beginStage()를 불러도 된다.
+    bool admit(FrameEnvelope& frame, PipelineStage stage) const;
+
+    uint64_t droppedCount(PipelineStage stage) const;
+
+private:
+    std::array<int64_t, PIPELINE_STAGE_COUNT> deadlineNs{};
+    mutable std::array<std::atomic<uint64_t>, PIPELINE_STAGE_COUNT> dropped{};
+};
+
+#endif // FRAME_H
@@ -0,0 +1,76 @@
+// include/FrameRing.h
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "PipelineStage.h"  // monotonicNowNs
+
+// 링에서 읽은 프레임. image는 공유 메모리를 직접 가리키는 헤더이므로 복사가 없다.
+// 소비 프로세스의 매핑은 읽기 전용이라 image에 쓰면 SIGSEGV가 발생한다.
+struct SharedFrame {
+    cv::Mat image;
+    uint64_t sequence = 0;    // 캡처 순번 (1부터 증가)
+    int64_t timestampNs = 0;  // CLOCK_MONOTONIC 기준 캡처 시각
+};
+
+// POSIX 공유 메모리 위의 단일 생산자/다중 소비자 프레임 링 버퍼.
+// 캡처 프로세스가 create()로 링을 만들고 슬롯에 직접 프레임을 쓰며,
+// 탐지/로깅 등 소비 프로세스는 open()으로 같은 링을 매핑해 복사 없이 읽는다.
+// 슬롯마다 시퀀스 번호를 두어(seqlock) 읽는 도중 덮어써진 프레임을 감지한다.
+class FrameRing {
+public:
+    // 캡처 프로세스용: 링 생성. 같은 이름의 링이 남아 있으면 생성한 프로세스가 종료된 경우에만 제거하고,
+    // 아직 살아 있는 생산자의 링이면 std::runtime_error (소비자가 붙어 있는 링을 끊지 않도록)
+    static FrameRing create(const std::string& name, int width, int height, int type, int slotCount = 8);
+    // 소비 프로세스용: 기존 링을 읽기 전용으로 매핑
+    static FrameRing open(const std::string& name);
+
+    FrameRing(FrameRing&& other) noexcept;
+    FrameRing& operator=(FrameRing&& other) noexcept;
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+    ~FrameRing();
+
+    // 쓰기 1단계: 다음 슬롯을 가리키는 Mat 헤더를 반환 (여기에 바로 캡처)
+    cv::Mat beginWrite();
+    // 쓰기 2단계: beginWrite()로 받은 슬롯을 게시하고 시퀀스 번호를 반환
+    uint64_t publish(int64_t timestampNs);
+    // 이미 가진 프레임을 복사해서 게시
+    uint64_t write(const cv::Mat& frame, int64_t timestampNs);
+
+    // afterSequence보다 새로운 가장 최근 프레임을 읽음 (없으면 false)
+    bool readLatest(SharedFrame& frame, uint64_t afterSequence = 0) const;
+    // 특정 시퀀스의 프레임을 읽음 (이미 덮어써졌으면 false)
+    bool read(uint64_t sequence, SharedFrame& frame) const;
+    // 처리하는 동안 슬롯이 덮어써지지 않았는지 확인
+    bool isValid(const SharedFrame& frame) const;
+    // afterSequence보다 새로운 프레임이 게시될 때까지 대기 (timeoutMs 후 false)
+    bool waitForFrame(uint64_t afterSequence, int timeoutMs) const;
+
+    uint64_t latestSequence() const;
+    int width() const;
+    int height() const;
+    int type() const;
+    int slotCount() const;
+
+private:
+    struct Header;
+    struct SlotHeader;
+
+    FrameRing(std::string name, void* base, size_t size, bool owner);
+
+    Header* header() const;
+    static void removeStaleRing(const std::string& name);
+    SlotHeader* slotHeader(int slot) const;
+    unsigned char* slotData(int slot) const;
+
+    std::string name;
+    void* base = nullptr;
+    size_t size = 0;
+    bool owner = false;
+};
+
+#endif // FRAME_RING_H
@@ -0,0 +1,42 @@
+// include/ModelLoader.h
+#ifndef MODEL_LOADER_H
+#define MODEL_LOADER_H
+
+#include <torch/script.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 모델 가중치 로드 방식
+enum class ModelLoadMode {
+    Copy,           // torch::jit::load 기본 동작: 모든 가중치를 프로세스 힙에 복사
+    MemoryMapped    // 파일을 읽기 전용으로 매핑하고, 가중치 텐서를 매핑된 페이지 위에 바로 만듦 (CPU 전용)
+};
+
+struct ModelLoadStats {
+    ModelLoadMode mode = ModelLoadMode::Copy;  // 실제로 사용된 방식 (CPU가 아니면 Copy로 대체됨)
+    bool mappingSkipped = false;    // MemoryMapped를 요청했지만 Copy로 로드함 (CPU가 아닌 장치, 매핑으로 복원할 수 없는 아카이브)
+    std::string skipReason;         // mappingSkipped인 이유 (report()에 표시)
+    double loadMs = 0.0;
+    size_t rssBeforeBytes = 0;      // 로드 전후 프로세스 상주 메모리
+    size_t rssAfterBytes = 0;
+    size_t mappedBytes = 0;         // 매핑한 파일 크기
+    size_t sharedBytes = 0;         // 매핑을 직접 가리키는 가중치 저장소 크기 (페이지 캐시로 공유됨)
+    size_t privateBytes = 0;        // 매핑 밖(힙)에 있는 가중치 저장소 크기 (__setstate__ 등이 새로 만든 텐서)
+
+    int64_t rssDeltaBytes() const { return static_cast<int64_t>(rssAfterBytes) - static_cast<int64_t>(rssBeforeBytes); }
+    std::string report() const;
+};
+
+// TorchScript 모델 로드. MemoryMapped 모드에서는 torch::jit::load 대신 아카이브를 직접 복원하면서
+// 텐서 저장소를 매핑 위에 만들므로 가중치가 힙에 복사되지 않고, 같은 파일을 여는 모든 탐지기(같은 프로세스는
+// 매핑 자체, 다른 프로세스는 페이지 캐시)가 가중치 한 벌을 공유한다. 매핑은 읽기 전용이므로 가중치를
+// 제자리에서 수정하면 안 되며(추론 전용), GPU로 옮기는 모델은 어차피 장치 메모리에 복사되므로 Copy로 로드한다
+// (stats->mappingSkipped). 예전 model.json 아카이브나 .data/ts_code/ 아카이브처럼 기본 배치(code/ + data.pkl)가
+// 아닌 파일도 torch::jit::load로 대신 로드하고, 그 이유를 stats->skipReason에 남긴다.
+torch::jit::script::Module loadModel(const std::string& modelPath, const torch::Device& device, ModelLoadMode mode, ModelLoadStats* stats = nullptr);
+
+// 현재 프로세스의 상주 메모리 (/proc/self/statm, 바이트)
+size_t residentMemoryBytes();
+
+#endif // MODEL_LOADER_H
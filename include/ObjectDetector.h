@@ -3,28 +3,89 @@
 
 #include <opencv2/opencv.hpp>
 #include <torch/script.h>  // TorchScript를 위한 헤더 추가
+#include <memory>
 #include <string>
 #include <vector>
+#include "Frame.h"
+#include "ModelLoader.h"
+#include "SegmentationMask.h"
 
 struct Detection {
     cv::Rect box;
     float confidence;
     int class_id;
+    std::shared_ptr<SegmentationMask> mask;  // 세그멘테이션 모델일 때만 설정, 요청 시 디코딩
+};
+
+// 타일 추론 설정
+struct TilingOptions {
+    int tileSize = 640;       // 모델 입력 크기와 같은 정사각 타일
+    int overlap = 128;        // 인접 타일 간 겹침 (px), 작은 객체가 한 타일에 온전히 들어가도록
+    bool batchTiles = true;   // 모든 타일을 배치 하나로 추론 (동적 배치로 export된 모델 필요)
+};
+
+// 프레임마다 타일 추론을 할지 결정하는 정책.
+// 작은 객체가 보이는 동안에는 타일 추론을 유지하고, 아무것도 보이지 않으면
+// probeInterval 프레임마다 한 번씩 타일 추론으로 먼 객체를 탐색한다.
+class TilingPolicy {
+public:
+    float smallObjectPx = 32.0f;  // 짧은 변이 이보다 작은 객체가 있으면 타일 추론
+    int probeInterval = 15;       // 탐지가 없을 때 타일 추론으로 탐색하는 주기 (프레임)
+    float minGain = 1.25f;        // 원본/입력 해상도 비가 이보다 작으면 타일링 이득이 없음
+
+    bool shouldTile(const cv::Mat& frame, int tileSize) const;
+    void update(const std::vector<Detection>& detections, bool tiled);
+
+private:
+    bool smallTargets = false;
+    int framesWithoutDetections = 0;
 };
 
 class ObjectDetector {
 public:
     // 생성자에서 TorchScript 모델 경로와 클래스 이름 파일 경로를 받음
-    ObjectDetector(const std::string& modelPath, const std::string& classNamesPath, float confThreshold = 0.5f, float nmsThreshold = 0.4f);
+    // loadMode가 MemoryMapped이면 가중치를 파일 매핑에서 직접 사용 (여러 탐지기/프로세스가 한 벌을 공유).
+    // 매핑은 CPU 추론에서만 효과가 있으며, CUDA 장치면 가중치가 GPU로 복사되므로 Copy로 로드된다.
+    // 매핑된 가중치는 PROT_READ 페이지 위에 있으므로 제자리 쓰기는 SIGSEGV로 프로세스를 죽인다.
+    // torch::jit::freeze, torch::jit::optimize_for_inference(BN 접기 등)나 파라미터의 in-place 갱신이 필요하면 Copy를 쓸 것.
+    ObjectDetector(const std::string& modelPath, const std::string& classNamesPath, float confThreshold = 0.5f, float nmsThreshold = 0.4f,
+                   ModelLoadMode loadMode = ModelLoadMode::Copy, const torch::Device& device = defaultDevice());
+
+    // 이미 로드된 TorchScript 모듈과 클래스 이름을 직접 받는 생성자 (합성 모델 등)
+    ObjectDetector(torch::jit::script::Module module, std::vector<std::string> classNames, float confThreshold = 0.5f, float nmsThreshold = 0.4f,
+                   const torch::Device& device = defaultDevice());
+
+    // CUDA를 쓸 수 있으면 CUDA, 아니면 CPU
+    static torch::Device defaultDevice();
 
     // 객체 탐지를 수행하는 함수
     std::vector<Detection> detect(const cv::Mat& frame);
 
+    // 원본 해상도 프레임을 겹치는 타일로 나눠 배치 추론하고 결과를 병합 (작고 먼 객체용)
+    std::vector<Detection> detectTiled(const cv::Mat& frame, const TilingOptions& options = TilingOptions());
+
+    // 정책에 따라 전체 프레임 추론 또는 타일 추론을 선택
+    std::vector<Detection> detect(const cv::Mat& frame, TilingPolicy& policy, const TilingOptions& options = TilingOptions());
+
+    // 프레임 봉투 단위 탐지: 추론 단계 마감 시간을 넘긴 프레임은 추론하지 않고 빈 결과를 반환
+    // (frame.dropped로 확인). 추론 단계 시작/종료 시각을 봉투에 기록한다.
+    std::vector<Detection> detect(FrameEnvelope& frame, const StageDeadlines& deadlines);
+    // 위와 같되 정책에 따라 전체 프레임 추론 또는 타일 추론
+    std::vector<Detection> detect(FrameEnvelope& frame, const StageDeadlines& deadlines, TilingPolicy& policy, const TilingOptions& options = TilingOptions());
+
+    // 모델이 batchSize 배치 입력을 받는지 확인 (정적 배치로 export된 모델이면 false, TilingOptions::batchTiles 결정용)
+    bool supportsBatch(int batchSize);
+
     const std::vector<std::string>& getClassNames() const { return classNames; }
 
+    // 모델 로드 시간과 메모리 사용량 (경로로 생성한 경우에만 채워짐)
+    const ModelLoadStats& getLoadStats() const { return loadStats; }
+    const torch::Device& getDevice() const { return device; }
+
 private:
     // TorchScript 모델을 위한 변수
     torch::jit::script::Module model;
+    torch::Device device;  // 모델과 입력 텐서가 놓이는 장치
 
     // 클래스 이름 저장
     std::vector<std::string> classNames;
@@ -33,8 +94,13 @@ private:
     float confThreshold;
     float nmsThreshold;
 
+    ModelLoadStats loadStats;
+
     // 클래스 이름 로드 함수
     void loadClassNames(const std::string& classNamesPath);
+
+    // 봉투 단위 탐지 공통 경로: 마감 검사 후 policy가 있으면 정책에 따라, 없으면 전체 프레임 추론
+    std::vector<Detection> detectStage(FrameEnvelope& frame, const StageDeadlines& deadlines, TilingPolicy* policy, const TilingOptions& options);
 };
 
 #endif // OBJECT_DETECTOR_H
@@ -3,8 +3,33 @@
 
 #include <opencv2/opencv.hpp>
 #include "CameraConstants.h"  // Camera-related constants
+#include <cmath>
+#include <string>
 #include <vector>
 #include "ObjectDetector.h"   // Include the Detection struct
+#include "Frame.h"            // Frame envelope and stage deadlines
+
+// Distance estimate for a single detection
+struct ObjectDistance {
+    Detection detection;
+    std::string label;       // "Parcel", "Ring" or "Unknown"
+    float distanceCm = 0.0f; // NaN when the class has no known size
+
+    bool hasDistance() const { return !std::isnan(distanceCm); }
+};
+
+// Distance estimates for one frame, with enough timing to judge freshness
+struct DistanceResult {
+    uint64_t sequence = 0;
+    int64_t captureTimeNs = 0;
+    int64_t resultTimeNs = 0;   // When the estimates were produced
+    std::vector<ObjectDistance> objects;
+
+    // Glass-to-result latency
+    double latencyMs() const { return (resultTimeNs - captureTimeNs) / 1e6; }
+    // Age of the result right now
+    double ageMs() const { return (monotonicNowNs() - captureTimeNs) / 1e6; }
+};
 
 // Function declarations for calculating focal length and distance to object
 
@@ -14,7 +39,15 @@ float calculateFocalLength(float& focal_length_px, float& focal_length_py);
 // Calculate distance to an object using its perceived width in the image
 float distanceToCamera(float knownWidth, float focalLength, float perWidth);
 
+// Estimate the distance to each detected object (no printing or drawing).
+// Returns one entry per detection, in order; classes of unknown size get a NaN distance.
+std::vector<ObjectDistance> estimateObjectDistances(const std::vector<Detection>& detections);
+
 // Process detections and calculate distance for each detected object
 void calculateObjectDistances(const std::vector<Detection>& detections, cv::Mat& image);
 
+// Same as above for a frame envelope. Returns false without doing any work when the frame
+// already missed its postprocess deadline; otherwise fills result and draws on frame.image.
+bool calculateObjectDistances(const std::vector<Detection>& detections, FrameEnvelope& frame, const StageDeadlines& deadlines, DistanceResult& result);
+
 #endif  // OBJECT_DISTANCE_DETECTOR_H
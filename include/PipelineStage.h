@@ -0,0 +1,33 @@
+// include/PipelineStage.h
+#ifndef PIPELINE_STAGE_H
+#define PIPELINE_STAGE_H
+
+#include <cstdint>
+#include <time.h>
+
+// 파이프라인 단계
+enum class PipelineStage {
+    CAPTURE = 0,
+    INFERENCE,
+    POSTPROCESS
+};
+
+const int PIPELINE_STAGE_COUNT = 3;
+
+inline const char* stageName(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::CAPTURE: return "capture";
+        case PipelineStage::INFERENCE: return "inference";
+        case PipelineStage::POSTPROCESS: return "postprocess";
+    }
+    return "unknown";
+}
+
+// 현재 시각 (CLOCK_MONOTONIC, ns). 프레임 봉투, 공유 메모리 링 타임스탬프, 마감 시간이 모두 이 시계를 사용
+inline int64_t monotonicNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+#endif // PIPELINE_STAGE_H
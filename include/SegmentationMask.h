@@ -0,0 +1,46 @@
+// include/SegmentationMask.h
+#ifndef SEGMENTATION_MASK_H
+#define SEGMENTATION_MASK_H
+
+#include <opencv2/opencv.hpp>
+#include <torch/torch.h>
+#include <atomic>
+#include <mutex>
+
+// 탐지 하나의 인스턴스 마스크. NMS를 통과한 탐지에만 만들어지며, 실제 디코딩
+// (마스크 계수 x 프로토타입)은 get()이 처음 호출될 때 박스 영역의 프로토타입만 잘라서 수행한다.
+// 프로토타입 텐서는 같은 프레임의 모든 마스크가 공유하므로 마스크가 살아 있는 동안 메모리에 남는다.
+class SegmentationMask {
+public:
+    // coefficients: [nm] 마스크 계수, proto: [nm, ph, pw] 프로토타입,
+    // inputBox: 모델 입력(letterbox) 좌표의 박스 (x1, y1, x2, y2), inputSize: 모델 입력 크기 (h, w),
+    // frameBox: 원본 프레임 좌표의 박스 (결과 마스크 크기)
+    SegmentationMask(torch::Tensor coefficients, torch::Tensor proto, cv::Rect2f inputBox, cv::Size inputSize, cv::Rect frameBox);
+
+    // frameBox 크기의 이진 마스크 (CV_8UC1, 0 또는 255). 처음 호출 시 계산 후 캐시
+    const cv::Mat& get() const;
+
+    // 이미 디코딩되었는지 여부
+    bool decoded() const;
+
+    // 원본 프레임에서 마스크가 놓이는 위치
+    const cv::Rect& box() const { return frameBox; }
+
+    // 크롭/타일 좌표로 만든 마스크를 원본 프레임 좌표로 옮김 (마스크 내용은 그대로)
+    void translate(const cv::Point& offset) { frameBox += offset; }
+
+private:
+    torch::Tensor coefficients;
+    torch::Tensor proto;
+    cv::Rect2f inputBox;
+    cv::Size inputSize;
+    cv::Rect frameBox;
+
+    mutable std::once_flag decodeOnce;
+    mutable cv::Mat mask;
+    mutable std::atomic<bool> isDecoded{false};
+
+    void decode() const;
+};
+
+#endif // SEGMENTATION_MASK_H
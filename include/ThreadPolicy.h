@@ -0,0 +1,85 @@
+// include/ThreadPolicy.h
+#ifndef THREAD_POLICY_H
+#define THREAD_POLICY_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "PipelineStage.h"
+
+// 단계별 스케줄링 정책
+struct StagePolicy {
+    std::vector<int> cpus;   // 고정할 CPU 코어 (비어 있으면 고정하지 않음)
+    int fifoPriority = 0;    // 1~99면 SCHED_FIFO 적용, 0이면 기본 스케줄러 유지
+};
+
+// 단계별 누적 스케줄링 통계
+struct StageStats {
+    uint64_t entries = 0;              // 단계 진입 횟수
+    uint64_t voluntarySwitches = 0;    // 자발적 문맥 교환 (I/O, 대기)
+    uint64_t involuntarySwitches = 0;  // 비자발적 문맥 교환 (선점)
+    uint64_t migrations = 0;           // CPU 코어 이동
+};
+
+// 캡처/추론/후처리 스레드를 지정한 코어에 고정하고 libtorch, OpenCV 스레드 풀 크기를 맞춘다.
+// 단계마다 전용 스레드를 두고, 각 스레드는 시작할 때 bind()로 한 번만 고정한다 (프레임마다 코어를
+// 옮기면 정책 자체가 이동과 지터를 만든다). enter()/leave()는 통계만 측정한다.
+// 풀 작업자 스레드는 생성 시점의 affinity를 물려받으므로, configureThreadPools()는 추론 스레드에서
+// bind(INFERENCE) 직후, 다른 병렬 구간(cv::undistort, model.forward 등)보다 먼저 호출해야 한다.
+class SchedulingPolicy {
+public:
+    SchedulingPolicy() = default;
+    // YAML/JSON 설정 파일에서 정책을 읽음 (cv::FileStorage 형식)
+    explicit SchedulingPolicy(const std::string& configPath);
+
+    StagePolicy& stage(PipelineStage stage) { return stages[static_cast<int>(stage)]; }
+    const StagePolicy& stage(PipelineStage stage) const { return stages[static_cast<int>(stage)]; }
+
+    // libtorch intra-op 스레드 수와 OpenCV parallel_for_ 스레드 수 (0이면 추론 코어 수에 맞춤)
+    int torchThreads = 0;
+    int opencvThreads = 0;
+
+    // 스레드 풀 크기를 설정하고 호출 스레드에서 풀을 미리 띄움
+    void configureThreadPools() const;
+
+    // 호출 스레드를 해당 단계의 코어와 우선순위에 고정 (스레드 시작 시 한 번)
+    // (이미 같은 정책이 적용된 스레드면 시스템 콜을 생략)
+    void bind(PipelineStage stage);
+
+    // 해당 단계의 통계 측정을 시작 (스레드 고정은 바꾸지 않음)
+    void enter(PipelineStage stage);
+    // 현재 단계의 통계 측정을 마침
+    void leave();
+
+    StageStats stats(PipelineStage stage) const;
+    std::string report() const;
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> entries{0};
+        std::atomic<uint64_t> voluntarySwitches{0};
+        std::atomic<uint64_t> involuntarySwitches{0};
+        std::atomic<uint64_t> migrations{0};
+    };
+
+    std::array<StagePolicy, PIPELINE_STAGE_COUNT> stages;
+    std::array<Counters, PIPELINE_STAGE_COUNT> counters;
+
+    void apply(PipelineStage stage) const;
+};
+
+// 단계 진입/이탈을 범위로 묶는 헬퍼
+class StageScope {
+public:
+    StageScope(SchedulingPolicy& policy, PipelineStage stage) : policy(policy) { policy.enter(stage); }
+    ~StageScope() { policy.leave(); }
+    StageScope(const StageScope&) = delete;
+    StageScope& operator=(const StageScope&) = delete;
+
+private:
+    SchedulingPolicy& policy;
+};
+
+#endif // THREAD_POLICY_H
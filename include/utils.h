@@ -16,7 +16,8 @@ float generate_scale(const cv::Mat& image, const std::vector<int>& target_size);
 float letterbox(const cv::Mat &input_image, cv::Mat &output_image, const std::vector<int> &target_size);
 
 // non_max_suppression 함수 선언
-torch::Tensor non_max_suppression(torch::Tensor& prediction, float conf_thres = 0.25, float iou_thres = 0.45, int max_det = 300);
+// nm: 클래스 점수 뒤에 붙은 마스크 계수 채널 수 (세그멘테이션 모델), 출력 행은 [x1, y1, x2, y2, conf, cls, mask...]
+torch::Tensor non_max_suppression(torch::Tensor& prediction, float conf_thres = 0.25, float iou_thres = 0.45, int max_det = 300, int nm = 0);
 
 // xywh2xyxy 변환 함수 선언
 torch::Tensor xywh2xyxy(const torch::Tensor& x);
@@ -27,6 +28,9 @@ torch::Tensor nms(const torch::Tensor& bboxes, const torch::Tensor& scores, floa
 // scale_boxes 함수 선언
 torch::Tensor scale_boxes(const std::vector<int>& img1_shape, torch::Tensor& boxes, const std::vector<int>& img0_shape);
 
+// merge_tile_detections 함수 선언 (타일 경계에서 잘린 박스 연결 + 타일 간 NMS)
+std::vector<Detection> merge_tile_detections(const std::vector<Detection>& detections, const std::vector<int>& tile_ids, const std::vector<cv::Rect>& tiles, const cv::Size& frame_size, float iou_thres, int seam_margin = 4);
+
 // draw_and_save_results 함수 선언
 void draw_and_save_results(const cv::Mat& original_image, const std::vector<Detection>& detections, const std::vector<std::string>& class_names, const std::string& output_image_path);
 
@@ -0,0 +1,529 @@
+// src/BatchProcessor.cpp
+#include "BatchProcessor.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const char kTableMagic[8] = {'D', 'P', 'D', 'E', 'T', 'C', 'O', 'L'};
+const uint32_t kTableVersion = 1;
+const uint32_t kTableColumns = 8;
+
+struct FrameJob {
+    uint32_t frame = 0;
+    cv::Mat image;
+};
+
+// 작업자별 큐 묶음. push는 큐를 번갈아 고르고 전체 대기 수가 capacity를 넘으면 막힌다.
+// pop은 먼저 대기 중인 프레임 하나를 예약한 뒤 자기 큐 앞쪽, 없으면 다른 큐 뒤쪽에서 꺼낸다.
+// 프레임을 큐에 넣은 뒤에만 예약 가능 수를 늘리므로 예약한 작업자는 항상 프레임을 찾는다.
+class WorkStealingQueues {
+public:
+    WorkStealingQueues(int lanes, int capacity) : capacity(static_cast<size_t>(std::max(capacity, 1))) {
+        for (int i = 0; i < lanes; ++i) {
+            this->lanes.push_back(std::make_unique<Lane>());
+        }
+    }
+
+    void push(FrameJob job) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this]() { return queued < capacity; });
+            ++queued;
+        }
+        Lane& lane = *lanes[next.fetch_add(1, std::memory_order_relaxed) % lanes.size()];
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            lane.jobs.push_back(std::move(job));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++available;
+        }
+        notEmpty.notify_one();
+    }
+
+    // 더 이상 프레임이 없고 close()된 경우 false
+    bool pop(int worker, FrameJob& job, bool& stolen) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this]() { return available > 0 || closed; });
+            if (available == 0) {
+                return false;
+            }
+            --available;
+        }
+
+        const size_t n = lanes.size();
+        for (size_t attempt = 0;; ++attempt) {
+            size_t index = (worker + attempt) % n;
+            Lane& lane = *lanes[index];
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            if (lane.jobs.empty()) {
+                continue;
+            }
+            stolen = index != static_cast<size_t>(worker);
+            if (stolen) {
+                job = std::move(lane.jobs.back());
+                lane.jobs.pop_back();
+            } else {
+                job = std::move(lane.jobs.front());
+                lane.jobs.pop_front();
+            }
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --queued;
+        }
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+    }
+
+private:
+    struct Lane {
+        std::mutex mutex;
+        std::deque<FrameJob> jobs;
+    };
+
+    std::vector<std::unique_ptr<Lane>> lanes;
+    std::atomic<size_t> next{0};
+
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    size_t capacity;
+    size_t queued = 0;      // 큐에 들어 있는 프레임 수
+    size_t available = 0;   // 그중 아직 예약되지 않은 프레임 수
+    bool closed = false;
+};
+
+// 오버레이 이미지를 별도 스레드에서 그리고 저장 (탐지 작업자가 imwrite를 기다리지 않도록)
+class AsyncOverlayWriter {
+public:
+    AsyncOverlayWriter(std::vector<std::string> classNames, int capacity)
+        : classNames(std::move(classNames)), capacity(static_cast<size_t>(std::max(capacity, 1))),
+          thread(&AsyncOverlayWriter::loop, this) {}
+
+    ~AsyncOverlayWriter() { finish(); }
+
+    // 남은 오버레이를 모두 저장하고 스레드를 종료
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void push(cv::Mat image, std::vector<Detection> detections, std::string path) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return pending.size() < capacity; });
+        pending.push_back({std::move(image), std::move(detections), std::move(path)});
+        lock.unlock();
+        notEmpty.notify_one();
+    }
+
+    uint64_t written() const { return count.load(std::memory_order_relaxed); }
+    // 저장 중 처음 발생한 예외 (finish() 이후에 확인). 실패해도 나머지 오버레이는 계속 저장
+    std::exception_ptr error() const { return firstError; }
+
+private:
+    struct Overlay {
+        cv::Mat image;
+        std::vector<Detection> detections;
+        std::string path;
+    };
+
+    std::vector<std::string> classNames;
+    size_t capacity;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<Overlay> pending;
+    bool closed = false;
+    std::atomic<uint64_t> count{0};
+    std::exception_ptr firstError;
+    std::thread thread;
+
+    void loop() {
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this]() { return !pending.empty() || closed; });
+            if (pending.empty()) {
+                return;
+            }
+            Overlay overlay = std::move(pending.front());
+            pending.pop_front();
+            lock.unlock();
+            notFull.notify_one();
+
+            // 스레드 밖으로 예외가 나가면 std::terminate이므로 작업자 오류처럼 기록해 두었다가 run()에서 다시 던짐
+            try {
+                draw_and_save_results(overlay.image, overlay.detections, classNames, overlay.path);
+                count.fetch_add(1, std::memory_order_relaxed);
+            } catch (...) {
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+    }
+};
+
+bool isImageFile(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".tif" || ext == ".tiff";
+}
+
+template <typename T>
+void writeColumn(std::ofstream& ofs, const std::vector<T>& column) {
+    ofs.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+}
+
+template <typename T>
+void readColumn(std::ifstream& ifs, std::vector<T>& column, uint64_t rows) {
+    column.resize(rows);
+    ifs.read(reinterpret_cast<char*>(column.data()), static_cast<std::streamsize>(rows * sizeof(T)));
+}
+
+}  // namespace
+
+void DetectionTable::append(uint32_t frameIndex, const Detection& detection, float distance) {
+    frame.push_back(frameIndex);
+    classId.push_back(static_cast<uint16_t>(detection.class_id));
+    confidence.push_back(detection.confidence);
+    x.push_back(detection.box.x);
+    y.push_back(detection.box.y);
+    width.push_back(detection.box.width);
+    height.push_back(detection.box.height);
+    distanceCm.push_back(distance);
+}
+
+void DetectionTable::append(const DetectionTable& other) {
+    frame.insert(frame.end(), other.frame.begin(), other.frame.end());
+    classId.insert(classId.end(), other.classId.begin(), other.classId.end());
+    confidence.insert(confidence.end(), other.confidence.begin(), other.confidence.end());
+    x.insert(x.end(), other.x.begin(), other.x.end());
+    y.insert(y.end(), other.y.begin(), other.y.end());
+    width.insert(width.end(), other.width.begin(), other.width.end());
+    height.insert(height.end(), other.height.begin(), other.height.end());
+    distanceCm.insert(distanceCm.end(), other.distanceCm.begin(), other.distanceCm.end());
+}
+
+void DetectionTable::sortByFrame() {
+    std::vector<size_t> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return frame[a] < frame[b]; });
+
+    auto permute = [&order](auto& column) {
+        auto sorted = column;
+        for (size_t i = 0; i < order.size(); ++i) {
+            sorted[i] = column[order[i]];
+        }
+        column.swap(sorted);
+    };
+    permute(frame);
+    permute(classId);
+    permute(confidence);
+    permute(x);
+    permute(y);
+    permute(width);
+    permute(height);
+    permute(distanceCm);
+}
+
+void DetectionTable::save(const std::string& path) const {
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs.is_open()) {
+        throw std::runtime_error("결과 파일을 열 수 없습니다: " + path);
+    }
+
+    uint64_t rows = size();
+    ofs.write(kTableMagic, sizeof(kTableMagic));
+    ofs.write(reinterpret_cast<const char*>(&kTableVersion), sizeof(kTableVersion));
+    ofs.write(reinterpret_cast<const char*>(&kTableColumns), sizeof(kTableColumns));
+    ofs.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    writeColumn(ofs, frame);
+    writeColumn(ofs, classId);
+    writeColumn(ofs, confidence);
+    writeColumn(ofs, x);
+    writeColumn(ofs, y);
+    writeColumn(ofs, width);
+    writeColumn(ofs, height);
+    writeColumn(ofs, distanceCm);
+
+    if (!ofs) {
+        throw std::runtime_error("결과 파일을 쓰는 데 실패했습니다: " + path);
+    }
+}
+
+DetectionTable DetectionTable::load(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("결과 파일을 열 수 없습니다: " + path);
+    }
+
+    char magic[sizeof(kTableMagic)];
+    uint32_t version = 0;
+    uint32_t columns = 0;
+    uint64_t rows = 0;
+    ifs.read(magic, sizeof(magic));
+    ifs.read(reinterpret_cast<char*>(&version), sizeof(version));
+    ifs.read(reinterpret_cast<char*>(&columns), sizeof(columns));
+    ifs.read(reinterpret_cast<char*>(&rows), sizeof(rows));
+    if (!ifs || std::memcmp(magic, kTableMagic, sizeof(magic)) != 0 || version != kTableVersion || columns != kTableColumns) {
+        throw std::runtime_error("탐지 결과 파일 형식이 아닙니다: " + path);
+    }
+
+    DetectionTable table;
+    readColumn(ifs, table.frame, rows);
+    readColumn(ifs, table.classId, rows);
+    readColumn(ifs, table.confidence, rows);
+    readColumn(ifs, table.x, rows);
+    readColumn(ifs, table.y, rows);
+    readColumn(ifs, table.width, rows);
+    readColumn(ifs, table.height, rows);
+    readColumn(ifs, table.distanceCm, rows);
+    if (!ifs) {
+        throw std::runtime_error("결과 파일이 잘렸습니다: " + path);
+    }
+    return table;
+}
+
+BatchProcessor::BatchProcessor(DetectorFactory factory, const BatchOptions& options)
+    : factory(std::move(factory)), options(options) {
+    if (this->options.workers <= 0) {
+        this->options.workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    this->options.decoders = std::max(this->options.decoders, 1);
+}
+
+DetectionTable BatchProcessor::run(const std::string& input) {
+    namespace fs = std::filesystem;
+    auto start = std::chrono::steady_clock::now();
+    sources.clear();
+    stats = BatchStats();
+
+    // 작업자별 탐지기는 스레드를 띄우기 전에 만들어 로드 실패를 바로 알림
+    std::vector<std::unique_ptr<ObjectDetector>> detectors;
+    for (int i = 0; i < options.workers; ++i) {
+        detectors.push_back(factory());
+    }
+
+    std::unique_ptr<AsyncOverlayWriter> overlays;
+    if (!options.overlayDir.empty()) {
+        fs::create_directories(options.overlayDir);
+        overlays = std::make_unique<AsyncOverlayWriter>(detectors.front()->getClassNames(), options.overlayQueueCapacity);
+    }
+
+    // 원본 목록과 디코더별 작업 정의
+    std::vector<fs::path> files;
+    int64_t videoFrames = 0;
+    int decoders = options.decoders;
+    std::mutex sourcesMutex;
+    const bool isDirectory = fs::is_directory(input);
+    if (isDirectory) {
+        for (const auto& entry : fs::directory_iterator(input)) {
+            if (entry.is_regular_file() && isImageFile(entry.path())) {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const auto& file : files) {
+            sources.push_back({file.string(), 0});
+        }
+        decoders = std::min<int>(decoders, static_cast<int>(files.size()));
+    } else {
+        cv::VideoCapture probe(input);
+        if (!probe.isOpened()) {
+            throw std::runtime_error("영상 소스를 열 수 없습니다: " + input);
+        }
+        videoFrames = static_cast<int64_t>(probe.get(cv::CAP_PROP_FRAME_COUNT));
+        if (videoFrames > 0) {
+            for (int64_t i = 0; i < videoFrames; ++i) {
+                sources.push_back({input, i});
+            }
+        } else {
+            // 프레임 수를 알 수 없는 스트림은 구간을 나눌 수 없으므로 디코더 하나로 처음부터 읽음
+            decoders = 1;
+        }
+    }
+
+    WorkStealingQueues queues(options.workers, options.queueCapacity);
+    std::atomic<uint64_t> decodeFailures{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto recordError = [&]() {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    };
+
+    // 디코더: 디렉터리는 파일을 하나씩 나눠 가지고, 동영상은 구간마다 자기 VideoCapture로 탐색 후 순서대로 읽음
+    std::atomic<size_t> nextFile{0};
+    auto decode = [&](int decoder) {
+        try {
+            if (isDirectory) {
+                for (size_t i = nextFile.fetch_add(1); i < files.size(); i = nextFile.fetch_add(1)) {
+                    cv::Mat image = cv::imread(files[i].string(), cv::IMREAD_COLOR);
+                    if (image.empty()) {
+                        decodeFailures.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    queues.push({static_cast<uint32_t>(i), std::move(image)});
+                }
+                return;
+            }
+            cv::VideoCapture cap(input);
+            int64_t begin = 0;
+            int64_t end = std::numeric_limits<int64_t>::max();
+            if (videoFrames > 0) {
+                begin = videoFrames * decoder / decoders;
+                end = videoFrames * (decoder + 1) / decoders;
+                if (begin > 0) {
+                    cap.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(begin));
+                }
+            }
+            for (int64_t i = begin; i < end; ++i) {
+                cv::Mat image;
+                if (!cap.read(image) || image.empty()) {
+                    if (videoFrames > 0) {
+                        decodeFailures.fetch_add(static_cast<uint64_t>(end - i), std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                if (videoFrames <= 0) {
+                    std::lock_guard<std::mutex> lock(sourcesMutex);
+                    sources.push_back({input, i});
+                }
+                queues.push({static_cast<uint32_t>(i), std::move(image)});
+            }
+        } catch (...) {
+            recordError();
+        }
+    };
+
+    // 작업자: 탐지 -> 거리 추정 -> 작업자별 표에 기록, 필요하면 오버레이를 저장 스레드로 넘김
+    std::vector<DetectionTable> tables(options.workers);
+    std::vector<uint64_t> frameCounts(options.workers, 0);
+    std::vector<uint64_t> stolenCounts(options.workers, 0);
+    auto work = [&](int worker) {
+        ObjectDetector& detector = *detectors[worker];
+        DetectionTable& table = tables[worker];
+        FrameJob job;
+        bool stolen = false;
+        while (queues.pop(worker, job, stolen)) {
+            try {
+                std::vector<Detection> detections = detector.detect(job.image);
+                std::vector<ObjectDistance> objects = estimateObjectDistances(detections);
+
+                // 탐지마다 하나씩, 같은 순서로 반환됨 (거리를 모르는 클래스는 NaN)
+                for (size_t i = 0; i < detections.size(); ++i) {
+                    table.append(job.frame, detections[i], objects[i].distanceCm);
+                }
+
+                ++frameCounts[worker];
+                stolenCounts[worker] += stolen ? 1 : 0;
+                if (overlays) {
+                    std::string path = (fs::path(options.overlayDir) / cv::format("frame_%06u.jpg", job.frame)).string();
+                    overlays->push(std::move(job.image), std::move(detections), std::move(path));
+                }
+            } catch (...) {
+                recordError();
+            }
+        }
+    };
+
+    std::vector<std::thread> workerThreads;
+    for (int i = 0; i < options.workers; ++i) {
+        workerThreads.emplace_back(work, i);
+    }
+    std::vector<std::thread> decoderThreads;
+    for (int i = 0; i < decoders; ++i) {
+        decoderThreads.emplace_back(decode, i);
+    }
+    for (auto& thread : decoderThreads) {
+        thread.join();
+    }
+    queues.close();
+    for (auto& thread : workerThreads) {
+        thread.join();
+    }
+    if (overlays) {
+        overlays->finish();
+        stats.overlaysWritten = overlays->written();
+        if (!error) {
+            error = overlays->error();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    DetectionTable result;
+    for (int i = 0; i < options.workers; ++i) {
+        result.append(tables[i]);
+        stats.frames += frameCounts[i];
+        stats.stolenFrames += stolenCounts[i];
+    }
+    result.sortByFrame();
+
+    stats.detections = result.size();
+    stats.decodeFailures = decodeFailures.load();
+    stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void BatchProcessor::saveManifest(const std::string& path) const {
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) {
+        throw std::runtime_error("매니페스트 파일을 열 수 없습니다: " + path);
+    }
+    ofs << "frame,source,source_frame\n";
+    for (size_t i = 0; i < sources.size(); ++i) {
+        ofs << i << ",\"" << sources[i].path << "\"," << sources[i].sourceFrame << "\n";
+    }
+}
+
+std::string BatchProcessor::report() const {
+    std::ostringstream oss;
+    oss << "batch: frames=" << stats.frames
+        << ", detections=" << stats.detections
+        << ", workers=" << options.workers
+        << ", stolen=" << stats.stolenFrames
+        << ", decode failures=" << stats.decodeFailures
+        << ", overlays=" << stats.overlaysWritten
+        << ", " << stats.elapsedMs << " ms (" << stats.fps() << " fps)";
+    return oss.str();
+}
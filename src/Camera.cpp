@@ -32,6 +32,15 @@ Camera::Camera(int deviceID, CameraType type)
     }
 }
 
+Camera::Camera(const std::string& source)
+    : cameraType(CameraType::REPLAY) {
+    cap.open(source);
+
+    if (!cap.isOpened()) {
+        throw std::runtime_error("영상 소스를 열 수 없습니다: " + source);
+    }
+}
+
 cv::Mat Camera::getFrame() {
     cv::Mat frame;
     cap.read(frame);
@@ -39,6 +48,25 @@ cv::Mat Camera::getFrame() {
     return frame;
 }
 
+bool Camera::getFrame(cv::Mat& frame) {
+    // 크기와 형식이 같으면 VideoCapture가 기존 버퍼를 재사용함
+    return cap.read(frame) && !frame.empty();
+}
+
+bool Camera::capture(FrameEnvelope& frame) {
+    // 같은 크기의 버퍼를 VideoCapture가 재사용하도록 image는 유지
+    frame.reset();
+    // 캡처 단계 시간에 프레임 대기/읽기 시간이 포함되도록 읽기 전에 시작 시각을 기록
+    frame.beginStage(PipelineStage::CAPTURE);
+    if (!getFrame(frame.image)) {
+        return false;
+    }
+    // 드라이버 타임스탬프는 백엔드마다 달라 읽기 직후의 단조 시각을 캡처 시각으로 사용
+    frame.captureTimeNs = monotonicNowNs();
+    frame.sequence = ++sequence;
+    return true;
+}
+
 std::string Camera::gstreamerPipeline (int capture_width, int capture_height, int display_width, int display_height, int framerate, int flip_method) {
     return "nvarguscamerasrc ! video/x-raw(memory:NVMM), width=(int)" + std::to_string(capture_width) +
            ", height=(int)" + std::to_string(capture_height) + ", framerate=(fraction)" + std::to_string(framerate) +
@@ -0,0 +1,149 @@
+// src/CascadeDetector.cpp
+#include "CascadeDetector.h"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+float iou(const cv::Rect& a, const cv::Rect& b) {
+    float inter = static_cast<float>((a & b).area());
+    if (inter <= 0.0f) {
+        return 0.0f;
+    }
+    return inter / (a.area() + b.area() - inter);
+}
+
+}  // namespace
+
+CascadeDetector::CascadeDetector(std::unique_ptr<ObjectDetector> smallDetector, std::unique_ptr<ObjectDetector> largeDetector, const CascadeOptions& options)
+    : smallDetector(std::move(smallDetector)), largeDetector(std::move(largeDetector)), options(options) {}
+
+CascadeDetector::CascadeDetector(const std::string& smallModelPath, const std::string& largeModelPath, const std::string& classNamesPath, const CascadeOptions& options)
+    : smallDetector(std::make_unique<ObjectDetector>(smallModelPath, classNamesPath, options.candidateThreshold, options.nmsThreshold)),
+      largeDetector(std::make_unique<ObjectDetector>(largeModelPath, classNamesPath, options.largeThreshold, options.nmsThreshold)),
+      options(options) {}
+
+std::vector<cv::Rect> CascadeDetector::escalationRegions(const std::vector<Detection>& uncertain, const cv::Size& frameSize) const {
+    const cv::Rect frameRect(cv::Point(0, 0), frameSize);
+
+    // 탐지 박스에 주변 여유를 붙이고 최소 크기를 보장
+    std::vector<cv::Rect> regions;
+    for (const auto& detection : uncertain) {
+        const cv::Rect& box = detection.box;
+        int w = std::max(static_cast<int>(box.width * (1.0f + 2.0f * options.contextMargin)), options.minCropSize);
+        int h = std::max(static_cast<int>(box.height * (1.0f + 2.0f * options.contextMargin)), options.minCropSize);
+        int cx = box.x + box.width / 2;
+        int cy = box.y + box.height / 2;
+        cv::Rect region = cv::Rect(cx - w / 2, cy - h / 2, w, h) & frameRect;
+        if (!region.empty()) {
+            regions.push_back(region);
+        }
+    }
+
+    // 겹치는 영역을 합쳐 큰 모델 호출 횟수를 줄임
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < regions.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < regions.size(); ++j) {
+                if ((regions[i] & regions[j]).area() > 0) {
+                    regions[i] |= regions[j];
+                    regions.erase(regions.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    return regions;
+}
+
+std::vector<Detection> CascadeDetector::detect(const cv::Mat& frame) {
+    ++stats.frames;
+
+    // 1단계: 작은 모델로 전체 프레임 탐지
+    std::vector<Detection> candidates = smallDetector->detect(frame);
+
+    // confidence가 낮거나, 다른 클래스 박스와 크게 겹치는 탐지는 애매한 것으로 분류
+    std::vector<bool> uncertainFlags(candidates.size(), false);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (candidates[i].confidence < options.acceptThreshold) {
+            uncertainFlags[i] = true;
+        }
+        for (size_t j = i + 1; j < candidates.size(); ++j) {
+            if (candidates[i].class_id != candidates[j].class_id &&
+                iou(candidates[i].box, candidates[j].box) > options.ambiguityIoU) {
+                uncertainFlags[i] = true;
+                uncertainFlags[j] = true;
+            }
+        }
+    }
+
+    std::vector<Detection> accepted;
+    std::vector<Detection> uncertain;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        (uncertainFlags[i] ? uncertain : accepted).push_back(candidates[i]);
+    }
+    if (uncertain.empty()) {
+        return accepted;
+    }
+
+    // 2단계: 애매한 영역만 큰 모델로 재검사
+    ++stats.escalatedFrames;
+    stats.uncertainDetections += uncertain.size();
+
+    std::vector<Detection> verified;
+    std::vector<cv::Rect> regions = escalationRegions(uncertain, frame.size());
+    if (static_cast<int>(regions.size()) > options.maxRegions) {
+        ++stats.fullFrameEscalations;
+        verified = largeDetector->detect(frame);
+    } else {
+        stats.escalatedRegions += regions.size();
+        for (const auto& region : regions) {
+            for (auto detection : largeDetector->detect(frame(region))) {
+                detection.box += region.tl();
+                if (detection.mask) {
+                    detection.mask->translate(region.tl());
+                }
+                verified.push_back(detection);
+            }
+        }
+    }
+
+    for (const auto& u : uncertain) {
+        for (const auto& v : verified) {
+            if (v.class_id == u.class_id && iou(u.box, v.box) > options.nmsThreshold) {
+                ++stats.confirmedDetections;
+                break;
+            }
+        }
+    }
+
+    // 결과 병합: 큰 모델 결과를 우선하고, 그와 겹치지 않는 확정 탐지만 유지.
+    // 큰 모델이 확인하지 못한 애매한 탐지는 버림
+    std::vector<Detection> detections = verified;
+    for (const auto& a : accepted) {
+        bool duplicate = false;
+        for (const auto& v : verified) {
+            if (v.class_id == a.class_id && iou(a.box, v.box) > options.nmsThreshold) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) {
+            detections.push_back(a);
+        }
+    }
+    return detections;
+}
+
+std::string CascadeDetector::report() const {
+    std::ostringstream oss;
+    oss << "cascade: frames=" << stats.frames
+        << ", escalated=" << stats.escalatedFrames
+        << " (" << stats.escalationRate() * 100.0 << "%)"
+        << ", regions=" << stats.escalatedRegions
+        << ", full-frame=" << stats.fullFrameEscalations
+        << ", confirmed=" << stats.confirmedDetections << "/" << stats.uncertainDetections;
+    return oss.str();
+}
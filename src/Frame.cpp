@@ -0,0 +1,52 @@
+// src/Frame.cpp
+#include "Frame.h"
+#include <stdexcept>
+
+StageDeadlines::StageDeadlines(const std::string& configPath) {
+    cv::FileStorage fs(configPath, cv::FileStorage::READ);
+    if (!fs.isOpened()) {
+        throw std::runtime_error("마감 시간 설정 파일을 열 수 없습니다: " + configPath);
+    }
+
+    cv::FileNode node = fs["deadlines_ms"];
+    if (node.empty()) {
+        return;
+    }
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        PipelineStage stage = static_cast<PipelineStage>(i);
+        cv::FileNode value = node[stageName(stage)];
+        if (!value.empty()) {
+            set(stage, static_cast<double>(value));
+        }
+    }
+}
+
+void StageDeadlines::set(PipelineStage stage, double deadlineMs) {
+    deadlineNs[static_cast<int>(stage)] = deadlineMs > 0.0 ? static_cast<int64_t>(deadlineMs * 1e6) : 0;
+}
+
+double StageDeadlines::get(PipelineStage stage) const {
+    return deadlineNs[static_cast<int>(stage)] / 1e6;
+}
+
+bool StageDeadlines::admit(FrameEnvelope& frame, PipelineStage stage) const {
+    int i = static_cast<int>(stage);
+    if (frame.dropped) {
+        return false;
+    }
+    if (deadlineNs[i] > 0 && frame.ageNs() > deadlineNs[i]) {
+        frame.dropped = true;
+        frame.droppedAt = stage;
+        dropped[i].fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // 호출자가 마감 검사 전에 이미 단계를 시작했다면(캡처 읽기, 왜곡 보정 등) 그 시작 시각을 유지
+    if (frame.stageStartNs[i] == 0) {
+        frame.beginStage(stage);
+    }
+    return true;
+}
+
+uint64_t StageDeadlines::droppedCount(PipelineStage stage) const {
+    return dropped[static_cast<int>(stage)].load(std::memory_order_relaxed);
+}
@@ -0,0 +1,350 @@
+// src/FrameRing.cpp
+#include "FrameRing.h"
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <csignal>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t kRingMagic = 0x474E5246;  // "FRNG"
+const uint32_t kRingVersion = 2;
+const size_t kPageSize = 4096;
+const size_t kSlotHeaderSize = 64;  // 프레임 데이터를 캐시 라인에 맞춰 시작
+
+// 다른 프로세스가 만드는 중인 링의 초기화를 기다리는 최대 시간과 확인 간격
+const int kInitWaitMs = 500;
+const int kInitPollMs = 10;
+
+// 슬롯 시퀀스가 0이면 생산자가 쓰는 중이라는 뜻
+const uint64_t kSlotBusy = 0;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string systemError(const std::string& what, const std::string& name) {
+    return what + " (" + name + "): " + std::strerror(errno);
+}
+
+bool processAlive(pid_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+}  // namespace
+
+struct FrameRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t type;
+    uint32_t slotCount;
+    uint64_t frameBytes;
+    uint64_t slotStride;
+    uint64_t dataOffset;
+    int32_t ownerPid;                                   // 링을 만든 캡처 프로세스 (생성 직후 가장 먼저 기록)
+    alignas(64) std::atomic<uint64_t> writeSequence;  // 마지막으로 게시된 시퀀스
+    alignas(64) std::atomic<uint32_t> notify;         // 소비자 대기용 futex 워드
+};
+
+struct FrameRing::SlotHeader {
+    std::atomic<uint64_t> sequence;
+    int64_t timestampNs;
+};
+
+FrameRing FrameRing::create(const std::string& name, int width, int height, int type, int slotCount) {
+    if (width <= 0 || height <= 0 || slotCount <= 0) {
+        throw std::invalid_argument("잘못된 프레임 링 크기입니다: " + name);
+    }
+
+    size_t frameBytes = static_cast<size_t>(width) * height * CV_ELEM_SIZE(type);
+    size_t dataOffset = alignUp(sizeof(Header), kPageSize);
+    size_t slotStride = alignUp(kSlotHeaderSize + frameBytes, kPageSize);
+    size_t totalSize = dataOffset + slotStride * slotCount;
+
+    // 이전 캡처 프로세스가 비정상 종료하며 남긴 링만 제거하고, 살아 있는 생산자의 링이면 실패
+    removeStaleRing(name);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        throw std::runtime_error(systemError("공유 메모리를 생성할 수 없습니다", name));
+    }
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error(systemError("공유 메모리 크기를 설정할 수 없습니다", name));
+    }
+    void* base = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error(systemError("공유 메모리를 매핑할 수 없습니다", name));
+    }
+
+    Header* h = new (base) Header;
+    h->ownerPid = static_cast<int32_t>(getpid());
+    h->width = width;
+    h->height = height;
+    h->type = type;
+    h->slotCount = static_cast<uint32_t>(slotCount);
+    h->frameBytes = frameBytes;
+    h->slotStride = slotStride;
+    h->dataOffset = dataOffset;
+    h->writeSequence.store(0, std::memory_order_relaxed);
+    h->notify.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < slotCount; ++i) {
+        SlotHeader* slot = new (static_cast<unsigned char*>(base) + dataOffset + slotStride * i) SlotHeader;
+        slot->sequence.store(kSlotBusy, std::memory_order_relaxed);
+        slot->timestampNs = 0;
+    }
+    // magic은 마지막에 기록해 초기화가 끝난 링만 소비자가 열도록 함
+    h->version = kRingVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = kRingMagic;
+
+    return FrameRing(name, base, totalSize, true);
+}
+
+void FrameRing::removeStaleRing(const std::string& name) {
+    pid_t ownerPid = 0;
+    bool currentFormat = false;
+    for (int waitedMs = 0;; waitedMs += kInitPollMs) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        bool initialized = false;
+        if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+            void* base = mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+            if (base != MAP_FAILED) {
+                const Header* h = static_cast<const Header*>(base);
+                initialized = h->magic != 0;
+                currentFormat = h->magic == kRingMagic && h->version == kRingVersion;
+                ownerPid = currentFormat ? h->ownerPid : 0;
+                munmap(base, sizeof(Header));
+            }
+        }
+        close(fd);
+        if (initialized) {
+            break;
+        }
+
+        // 크기나 magic이 아직 0이면 다른 프로세스가 ftruncate와 헤더 기록 사이에 있을 수 있으므로
+        // 지우지 않고 초기화가 끝나기를 기다림. 끝나지 않으면 사용 중인 것으로 보고 실패
+        if (waitedMs >= kInitWaitMs) {
+            throw std::runtime_error("프레임 링이 초기화 중이거나 초기화 도중 중단되었습니다. "
+                                     "사용 중인 프로세스가 없으면 /dev/shm에서 직접 삭제하세요: " + name);
+        }
+        usleep(kInitPollMs * 1000);
+    }
+
+    if (currentFormat && processAlive(ownerPid)) {
+        throw std::runtime_error("프레임 링을 다른 캡처 프로세스(pid " + std::to_string(ownerPid) + ")가 사용 중입니다: " + name);
+    }
+    shm_unlink(name.c_str());
+}
+
+FrameRing FrameRing::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error(systemError("공유 메모리를 열 수 없습니다", name));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error("프레임 링이 아직 초기화되지 않았습니다: " + name);
+    }
+    size_t totalSize = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, totalSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error(systemError("공유 메모리를 매핑할 수 없습니다", name));
+    }
+
+    FrameRing ring(name, base, totalSize, false);
+    const Header* h = ring.header();
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (h->magic != kRingMagic || h->version != kRingVersion ||
+        h->dataOffset + h->slotStride * h->slotCount > totalSize) {
+        throw std::runtime_error("프레임 링 형식이 올바르지 않습니다: " + name);
+    }
+    return ring;
+}
+
+FrameRing::FrameRing(std::string name, void* base, size_t size, bool owner)
+    : name(std::move(name)), base(base), size(size), owner(owner) {
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "프로세스 간 공유에는 lock-free atomic이 필요합니다.");
+    static_assert(sizeof(SlotHeader) <= kSlotHeaderSize, "슬롯 헤더가 예약 영역보다 큽니다.");
+}
+
+FrameRing::FrameRing(FrameRing&& other) noexcept
+    : name(std::move(other.name)), base(other.base), size(other.size), owner(other.owner) {
+    other.base = nullptr;
+    other.owner = false;
+}
+
+FrameRing& FrameRing::operator=(FrameRing&& other) noexcept {
+    if (this != &other) {
+        if (base != nullptr) {
+            munmap(base, size);
+        }
+        if (owner) {
+            shm_unlink(name.c_str());
+        }
+        name = std::move(other.name);
+        base = other.base;
+        size = other.size;
+        owner = other.owner;
+        other.base = nullptr;
+        other.owner = false;
+    }
+    return *this;
+}
+
+FrameRing::~FrameRing() {
+    if (base != nullptr) {
+        munmap(base, size);
+        base = nullptr;
+    }
+    if (owner) {
+        shm_unlink(name.c_str());
+        owner = false;
+    }
+}
+
+FrameRing::Header* FrameRing::header() const {
+    return static_cast<Header*>(base);
+}
+
+FrameRing::SlotHeader* FrameRing::slotHeader(int slot) const {
+    const Header* h = header();
+    return reinterpret_cast<SlotHeader*>(static_cast<unsigned char*>(base) + h->dataOffset + h->slotStride * slot);
+}
+
+unsigned char* FrameRing::slotData(int slot) const {
+    return reinterpret_cast<unsigned char*>(slotHeader(slot)) + kSlotHeaderSize;
+}
+
+cv::Mat FrameRing::beginWrite() {
+    if (!owner) {
+        throw std::logic_error("읽기 전용 프레임 링에는 쓸 수 없습니다: " + name);
+    }
+    Header* h = header();
+    uint64_t next = h->writeSequence.load(std::memory_order_relaxed) + 1;
+    int slot = static_cast<int>((next - 1) % h->slotCount);
+
+    // 슬롯을 쓰는 중으로 표시한 뒤 데이터를 기록 (seqlock 쓰기 측)
+    slotHeader(slot)->sequence.store(kSlotBusy, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return cv::Mat(h->height, h->width, h->type, slotData(slot));
+}
+
+uint64_t FrameRing::publish(int64_t timestampNs) {
+    Header* h = header();
+    uint64_t next = h->writeSequence.load(std::memory_order_relaxed) + 1;
+    SlotHeader* slot = slotHeader(static_cast<int>((next - 1) % h->slotCount));
+    slot->timestampNs = timestampNs;
+    slot->sequence.store(next, std::memory_order_release);
+    h->writeSequence.store(next, std::memory_order_release);
+
+    // 대기 중인 소비자 깨우기 (프로세스 간 futex이므로 PRIVATE 플래그 없음)
+    h->notify.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&h->notify), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    return next;
+}
+
+uint64_t FrameRing::write(const cv::Mat& frame, int64_t timestampNs) {
+    cv::Mat slot = beginWrite();
+    if (frame.size() != slot.size() || frame.type() != slot.type()) {
+        throw std::invalid_argument("프레임 크기 또는 형식이 링과 다릅니다: " + name);
+    }
+    frame.copyTo(slot);
+    return publish(timestampNs);
+}
+
+bool FrameRing::read(uint64_t sequence, SharedFrame& frame) const {
+    if (sequence == 0) {
+        return false;
+    }
+    const Header* h = header();
+    int slot = static_cast<int>((sequence - 1) % h->slotCount);
+    const SlotHeader* sh = slotHeader(slot);
+    if (sh->sequence.load(std::memory_order_acquire) != sequence) {
+        return false;
+    }
+    frame.image = cv::Mat(h->height, h->width, h->type, slotData(slot));
+    frame.sequence = sequence;
+    frame.timestampNs = sh->timestampNs;
+    return isValid(frame);
+}
+
+bool FrameRing::readLatest(SharedFrame& frame, uint64_t afterSequence) const {
+    // 읽는 사이에 생산자가 링을 한 바퀴 돌면 다시 시도
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint64_t latest = latestSequence();
+        if (latest == 0 || latest <= afterSequence) {
+            return false;
+        }
+        if (read(latest, frame)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FrameRing::isValid(const SharedFrame& frame) const {
+    if (frame.sequence == 0) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    int slot = static_cast<int>((frame.sequence - 1) % header()->slotCount);
+    return slotHeader(slot)->sequence.load(std::memory_order_relaxed) == frame.sequence;
+}
+
+bool FrameRing::waitForFrame(uint64_t afterSequence, int timeoutMs) const {
+    Header* h = header();
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    while (true) {
+        uint32_t observed = h->notify.load(std::memory_order_acquire);
+        if (latestSequence() > afterSequence) {
+            return true;
+        }
+
+        int64_t remainingNs = (static_cast<int64_t>(deadline.tv_sec) * 1000000000LL + deadline.tv_nsec) - monotonicNowNs();
+        if (remainingNs <= 0) {
+            return false;
+        }
+        struct timespec timeout;
+        timeout.tv_sec = remainingNs / 1000000000LL;
+        timeout.tv_nsec = remainingNs % 1000000000LL;
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&h->notify), FUTEX_WAIT, observed, &timeout, nullptr, 0);
+    }
+}
+
+uint64_t FrameRing::latestSequence() const {
+    return header()->writeSequence.load(std::memory_order_acquire);
+}
+
+int FrameRing::width() const { return header()->width; }
+int FrameRing::height() const { return header()->height; }
+int FrameRing::type() const { return header()->type; }
+int FrameRing::slotCount() const { return static_cast<int>(header()->slotCount); }
@@ -0,0 +1,254 @@
+// src/ModelLoader.cpp
+#include "ModelLoader.h"
+#include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/read_adapter_interface.h>
+#include <torch/csrc/jit/serialization/import.h>
+#include <torch/csrc/jit/serialization/import_export_helpers.h>
+#include <torch/csrc/jit/serialization/import_source.h>
+#include <torch/csrc/jit/serialization/unpickler.h>
+#include <torch/torch.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_set>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// 읽기 전용으로 매핑된 모델 파일. 같은 경로는 프로세스 안에서 매핑 하나를 공유한다.
+class MappedFile {
+public:
+    static std::shared_ptr<MappedFile> open(const std::string& path) {
+        static std::mutex mutex;
+        static std::map<std::string, std::weak_ptr<MappedFile>> cache;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto file = cache[path].lock()) {
+            return file;
+        }
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("모델 파일을 열 수 없습니다: " + path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("모델 파일 크기를 알 수 없습니다: " + path);
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("모델 파일을 매핑할 수 없습니다: " + path);
+        }
+
+        auto file = std::shared_ptr<MappedFile>(new MappedFile(static_cast<const char*>(addr), size));
+        cache[path] = file;
+        return file;
+    }
+
+    ~MappedFile() { munmap(const_cast<char*>(addr), length); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return addr; }
+    size_t size() const { return length; }
+
+private:
+    MappedFile(const char* addr, size_t length) : addr(addr), length(length) {}
+
+    const char* addr;
+    size_t length;
+};
+
+// PyTorchStreamReader가 파일 대신 매핑에서 읽도록 하는 어댑터 (코드와 pickle 레코드만 이 경로로 복사됨)
+class MappedReadAdapter : public caffe2::serialize::ReadAdapterInterface {
+public:
+    explicit MappedReadAdapter(std::shared_ptr<MappedFile> file) : file(std::move(file)) {}
+
+    size_t size() const override { return file->size(); }
+
+    size_t read(uint64_t pos, void* buf, size_t n, const char* /*what*/ = "") const override {
+        if (pos >= file->size()) {
+            return 0;
+        }
+        n = std::min<size_t>(n, file->size() - pos);
+        std::memcpy(buf, file->data() + pos, n);
+        return n;
+    }
+
+private:
+    std::shared_ptr<MappedFile> file;
+};
+
+// 아카이브 하나(constants.pkl, data.pkl)를 복원. 텐서 레코드는 압축 없이 64바이트 정렬로 저장되므로
+// PyTorchStreamReader가 알려 주는 레코드 위치의 매핑 주소를 그대로 텐서 저장소로 쓴다 (힙 복사 없음).
+c10::IValue readMappedArchive(caffe2::serialize::PyTorchStreamReader& reader, const std::shared_ptr<MappedFile>& file,
+                              const std::string& archive, torch::jit::TypeResolver typeResolver, const torch::Device& device) {
+    at::DataPtr pickle;
+    size_t pickleSize = 0;
+    std::tie(pickle, pickleSize) = reader.getRecord(archive + ".pkl");
+    size_t consumed = 0;
+    auto readPickle = [&](char* buffer, size_t len) -> size_t {
+        len = std::min(len, pickleSize - consumed);
+        std::memcpy(buffer, static_cast<const char*>(pickle.get()) + consumed, len);
+        consumed += len;
+        return len;
+    };
+
+    auto readRecord = [&](const std::string& name) -> at::DataPtr {
+        std::string record = archive + "/" + name;
+        size_t offset = reader.getRecordOffset(record);
+        if (offset >= file->size()) {
+            throw std::runtime_error("텐서 레코드가 모델 파일 범위를 벗어났습니다: " + record);
+        }
+        // 저장소가 살아 있는 동안 매핑이 해제되지 않도록 해제자 컨텍스트가 매핑을 잡고 있게 함
+        auto* owner = new std::shared_ptr<MappedFile>(file);
+        return at::DataPtr(const_cast<char*>(file->data() + offset), owner,
+                           [](void* ctx) { delete static_cast<std::shared_ptr<MappedFile>*>(ctx); }, at::Device(at::kCPU));
+    };
+
+    torch::jit::Unpickler unpickler(readPickle, std::move(typeResolver), torch::jit::ObjLoaderFunc, readRecord, device);
+    unpickler.set_version(reader.version());
+    return unpickler.parse_ivalue();
+}
+
+// 매핑 로더는 torch.jit.save의 기본 배치(code/ + data.pkl + data/)만 복원한다. 예전 model.json 아카이브나
+// torch.package로 묶인 .data/ts_code/ 아카이브는 torch::jit::load가 따로 처리하므로 그 이유를 돌려줌
+std::string unsupportedMappedLayout(caffe2::serialize::PyTorchStreamReader& reader) {
+    if (reader.hasRecord("model.json")) {
+        return "legacy model.json archive";
+    }
+    bool hasCode = false;
+    for (const auto& record : reader.getAllRecords()) {
+        if (record.rfind(".data/ts_code/", 0) == 0) {
+            return "packaged archive with .data/ts_code/";
+        }
+        hasCode = hasCode || record.rfind("code/", 0) == 0;
+    }
+    if (!hasCode || !reader.hasRecord("data.pkl")) {
+        return "archive has no code/ and data.pkl records";
+    }
+    return std::string();
+}
+
+// torch::jit::load와 같은 순서(코드 -> 상수 -> 모듈 객체)로 모듈을 복원하되 텐서 레코드만 매핑에서 가져옴
+torch::jit::script::Module loadMappedModule(const std::shared_ptr<caffe2::serialize::PyTorchStreamReader>& reader,
+                                            const std::shared_ptr<MappedFile>& file, const torch::Device& device) {
+    auto cu = std::make_shared<torch::jit::CompilationUnit>();
+    std::vector<c10::IValue> constants;
+    torch::jit::SourceImporter importer(cu, &constants, [&reader](const std::string& qualifier) {
+        return torch::jit::findSourceInArchiveFromQualifier(*reader, "code/", qualifier);
+    }, reader->version());
+    torch::jit::TypeResolver typeResolver = [&](const c10::QualifiedName& name) {
+        return c10::StrongTypePtr(cu, importer.loadType(name));
+    };
+
+    // 코드의 CONSTANTS.cN 참조가 풀리도록 상수 표를 먼저 채움
+    if (reader->hasRecord("constants.pkl")) {
+        for (const auto& constant : readMappedArchive(*reader, file, "constants", typeResolver, device).toTuple()->elements()) {
+            constants.push_back(constant);
+        }
+    }
+    return torch::jit::script::Module(readMappedArchive(*reader, file, "data", typeResolver, device).toObject());
+}
+
+// 파라미터/버퍼 저장소 중 매핑을 직접 가리키는 것과 그렇지 않은 것의 크기 집계
+void countMappedStorage(const torch::jit::script::Module& module, const MappedFile& file, ModelLoadStats& stats) {
+    std::unordered_set<const c10::StorageImpl*> seen;
+    auto count = [&](const torch::Tensor& tensor) {
+        if (!tensor.defined() || !tensor.has_storage() || !seen.insert(tensor.storage().unsafeGetStorageImpl()).second) {
+            return;
+        }
+        const char* data = static_cast<const char*>(tensor.storage().data());
+        size_t nbytes = tensor.storage().nbytes();
+        if (data >= file.data() && data + nbytes <= file.data() + file.size()) {
+            stats.sharedBytes += nbytes;
+        } else {
+            stats.privateBytes += nbytes;
+        }
+    };
+    for (const auto& parameter : module.parameters(/*recurse=*/true)) {
+        count(parameter);
+    }
+    for (const auto& buffer : module.buffers(/*recurse=*/true)) {
+        count(buffer);
+    }
+}
+
+}  // namespace
+
+size_t residentMemoryBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+torch::jit::script::Module loadModel(const std::string& modelPath, const torch::Device& device, ModelLoadMode mode, ModelLoadStats* stats) {
+    ModelLoadStats local;
+    ModelLoadStats& s = stats != nullptr ? *stats : local;
+    s = ModelLoadStats();
+    s.rssBeforeBytes = residentMemoryBytes();
+    auto start = std::chrono::steady_clock::now();
+
+    torch::jit::script::Module module;
+    std::shared_ptr<MappedFile> file;
+    std::shared_ptr<caffe2::serialize::PyTorchStreamReader> reader;
+    if (mode == ModelLoadMode::MemoryMapped) {
+        if (!device.is_cpu()) {
+            s.skipReason = "weights are copied to the GPU";
+        } else {
+            file = MappedFile::open(modelPath);
+            reader = std::make_shared<caffe2::serialize::PyTorchStreamReader>(std::make_shared<MappedReadAdapter>(file));
+            s.skipReason = unsupportedMappedLayout(*reader);
+        }
+    }
+
+    if (mode == ModelLoadMode::MemoryMapped && s.skipReason.empty()) {
+        s.mode = ModelLoadMode::MemoryMapped;
+        s.mappedBytes = file->size();
+
+        module = loadMappedModule(reader, file, device);
+        countMappedStorage(module, *file, s);
+    } else {
+        s.mode = ModelLoadMode::Copy;
+        s.mappingSkipped = mode == ModelLoadMode::MemoryMapped;
+        reader.reset();
+        file.reset();
+        module = torch::jit::load(modelPath, device);
+    }
+
+    s.loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    s.rssAfterBytes = residentMemoryBytes();
+    return module;
+}
+
+std::string ModelLoadStats::report() const {
+    std::ostringstream oss;
+    oss << "model load: " << (mode == ModelLoadMode::MemoryMapped ? "mmap" : "copy")
+        << (mappingSkipped ? " (mmap ignored: " + skipReason + ")" : std::string())
+        << ", " << loadMs << " ms"
+        << ", rss " << rssBeforeBytes / (1024 * 1024) << " -> " << rssAfterBytes / (1024 * 1024) << " MiB";
+    if (mode == ModelLoadMode::MemoryMapped) {
+        oss << ", mapped " << mappedBytes / 1024 << " KiB"
+            << ", shared " << sharedBytes / 1024 << " KiB"
+            << ", private " << privateBytes / 1024 << " KiB";
+    }
+    return oss.str();
+}
@@ -1,5 +1,7 @@
 #include "ObjectDetector.h"
 #include "utils.h"
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <stdexcept>
 #include <opencv2/opencv.hpp>
@@ -8,14 +10,47 @@
 using torch::indexing::Slice; // 추가된 부분
 using torch::indexing::None;  // 추가된 부분
 
+namespace {
+
+// 한 축을 tile 크기, overlap만큼 겹치는 구간으로 나눈 시작 위치들
+std::vector<int> tileOrigins(int length, int tile, int overlap) {
+    if (length <= tile) {
+        return {0};
+    }
+    int step = tile - overlap;
+    int count = (length - overlap + step - 1) / step;
+    std::vector<int> origins;
+    for (int i = 0; i < count; ++i) {
+        int origin = std::min(i * step, length - tile);
+        if (origins.empty() || origins.back() != origin) {
+            origins.push_back(origin);
+        }
+    }
+    return origins;
+}
+
+// 모델 출력 분리: 탐지 모델은 예측 텐서 하나, 세그멘테이션 모델은 (예측, 마스크 프로토타입) 튜플
+torch::Tensor splitModelOutput(const torch::jit::IValue& output, torch::Tensor* proto) {
+    if (output.isTuple()) {
+        const auto& elements = output.toTuple()->elements();
+        if (proto != nullptr && elements.size() > 1 && elements[1].isTensor()) {
+            *proto = elements[1].toTensor();
+        }
+        return elements[0].toTensor();
+    }
+    return output.toTensor();
+}
+
+}  // namespace
+
 // ObjectDetector 생성자
-ObjectDetector::ObjectDetector(const std::string& modelPath, const std::string& classNamesPath, float confThreshold, float nmsThreshold)
-    : confThreshold(confThreshold), nmsThreshold(nmsThreshold) {
+ObjectDetector::ObjectDetector(const std::string& modelPath, const std::string& classNamesPath, float confThreshold, float nmsThreshold,
+                               ModelLoadMode loadMode, const torch::Device& device)
+    : device(device), confThreshold(confThreshold), nmsThreshold(nmsThreshold) {
 
     // TorchScript 모델 로드
     try {
-        torch::Device device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU);  // CUDA 또는 CPU 선택
-        model = torch::jit::load(modelPath, device);  // 모델 로드
+        model = loadModel(modelPath, device, loadMode, &loadStats);  // 모델 로드
         model.eval();  // 평가 모드 설정
         model.to(device);
     } catch (const c10::Error& e) {
@@ -26,6 +61,18 @@ ObjectDetector::ObjectDetector(const std::string& modelPath, const std::string&
     loadClassNames(classNamesPath);
 }
 
+// 이미 로드된 모듈을 사용하는 생성자
+ObjectDetector::ObjectDetector(torch::jit::script::Module module, std::vector<std::string> classNames, float confThreshold, float nmsThreshold,
+                               const torch::Device& device)
+    : model(std::move(module)), device(device), classNames(std::move(classNames)), confThreshold(confThreshold), nmsThreshold(nmsThreshold) {
+    model.eval();  // 평가 모드 설정
+    model.to(device);
+}
+
+torch::Device ObjectDetector::defaultDevice() {
+    return torch::Device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU);  // CUDA 또는 CPU 선택
+}
+
 void ObjectDetector::loadClassNames(const std::string& classNamesPath) {
     std::ifstream ifs(classNamesPath);
     if (!ifs.is_open()) {
@@ -46,11 +93,11 @@ void ObjectDetector::loadClassNames(const std::string& classNamesPath) {
 // 객체 탐지 함수
 std::vector<Detection> ObjectDetector::detect(const cv::Mat& frame) {
     // 이미지 전처리
+    // 호출자의 프레임은 건드리지 않고, 축소된 입력 이미지에서 채널 순서를 변환 (BGR -> RGB)
     cv::Mat input_image;
-    cv::cvtColor(frame, frame, cv::COLOR_RGB2BGR);
     float resize_scale = letterbox(frame, input_image, {640, 640});
+    cv::cvtColor(input_image, input_image, cv::COLOR_BGR2RGB);
 
-    torch::Device device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU);  // CUDA 또는 CPU 선택
 
     torch::Tensor image_tensor = torch::from_blob(input_image.data, {input_image.rows, input_image.cols, 3}, torch::kByte).to(device);
     image_tensor = image_tensor.toType(torch::kFloat32).div(255);
@@ -59,10 +106,12 @@ std::vector<Detection> ObjectDetector::detect(const cv::Mat& frame) {
     // 모델 추론
     std::vector<torch::jit::IValue> inputs;
     inputs.push_back(image_tensor);
-    auto output = model.forward(inputs).toTensor();
+    torch::Tensor proto;
+    auto output = splitModelOutput(model.forward(inputs), &proto);
+    int nm = proto.defined() ? static_cast<int>(proto.size(1)) : 0;
 
     // 추론 결과 후처리 (NMS 포함)
-    auto keep = non_max_suppression(output, confThreshold, nmsThreshold)[0];
+    auto keep = non_max_suppression(output, confThreshold, nmsThreshold, 300, nm)[0];
 
     // NMS 후 바운딩 박스 좌표 가져오기
     torch::Tensor boxes = keep.index({Slice(), Slice(None, 4)});
@@ -70,6 +119,11 @@ std::vector<Detection> ObjectDetector::detect(const cv::Mat& frame) {
     // 이미지 크기에 맞게 박스 스케일링
     boxes = scale_boxes({input_image.rows, input_image.cols}, boxes, {frame.rows, frame.cols});
 
+    // scale_boxes와 같은 배율/여백 (프레임 좌표 -> 입력 좌표 역변환용)
+    float gain = std::min(static_cast<float>(input_image.rows) / frame.rows, static_cast<float>(input_image.cols) / frame.cols);
+    float pad_x = std::round((input_image.cols - frame.cols * gain) / 2.0f - 0.1f);
+    float pad_y = std::round((input_image.rows - frame.rows * gain) / 2.0f - 0.1f);
+
     // 스케일링된 박스를 원래 텐서에 반영
     keep.index_put_({Slice(), Slice(None, 4)}, boxes);
 
@@ -85,13 +139,185 @@ std::vector<Detection> ObjectDetector::detect(const cv::Mat& frame) {
         float x2 = box[2].item<float>();
         float y2 = box[3].item<float>();
 
+        // 박스가 letterbox 여백으로 삐져나갈 수 있으므로 모델 종류와 관계없이 프레임 안으로 자름
         Detection detection;
-        detection.box = cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2));
+        detection.box = cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)) & cv::Rect(0, 0, frame.cols, frame.rows);
         detection.confidence = conf;
         detection.class_id = class_id;
 
+        // 세그멘테이션 모델: NMS를 통과한 탐지에만 마스크를 붙이고, 디코딩은 요청 시 박스 영역만 수행
+        // 마스크가 잘린 프레임 박스와 같은 영역을 덮도록, 잘린 박스를 scale_boxes의 역변환으로 입력 좌표에 옮겨 사용
+        if (nm > 0) {
+            cv::Rect2f input_box(detection.box.x * gain + pad_x, detection.box.y * gain + pad_y,
+                                 detection.box.width * gain, detection.box.height * gain);
+            detection.mask = std::make_shared<SegmentationMask>(
+                keep[i].slice(0, 6, 6 + nm).clone(), proto[0],
+                input_box, cv::Size(input_image.cols, input_image.rows), detection.box);
+        }
+
         detections.push_back(detection);
     }
 
     return detections;
 }
+
+// 타일 추론 함수
+std::vector<Detection> ObjectDetector::detectTiled(const cv::Mat& frame, const TilingOptions& options) {
+    const int tileSize = options.tileSize;
+
+    // 원본 프레임을 겹치는 타일로 분할
+    std::vector<cv::Rect> tiles;
+    for (int y : tileOrigins(frame.rows, tileSize, options.overlap)) {
+        for (int x : tileOrigins(frame.cols, tileSize, options.overlap)) {
+            tiles.emplace_back(x, y, std::min(tileSize, frame.cols - x), std::min(tileSize, frame.rows - y));
+        }
+    }
+    const int numTiles = static_cast<int>(tiles.size());
+
+    // 타일 전처리를 병렬로 수행: 각 타일을 배치 텐서의 자기 위치에 바로 기록 (BGR -> RGB, 모자란 영역은 패딩)
+    torch::Tensor batch = torch::empty({numTiles, tileSize, tileSize, 3}, torch::kByte);
+    uint8_t* batchData = batch.data_ptr<uint8_t>();
+    cv::parallel_for_(cv::Range(0, numTiles), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            cv::Mat dst(tileSize, tileSize, CV_8UC3, batchData + static_cast<size_t>(i) * tileSize * tileSize * 3);
+            if (tiles[i].width < tileSize || tiles[i].height < tileSize) {
+                dst.setTo(cv::Scalar(114, 114, 114));
+            }
+            cv::Mat roi = dst(cv::Rect(0, 0, tiles[i].width, tiles[i].height));
+            cv::cvtColor(frame(tiles[i]), roi, cv::COLOR_BGR2RGB);
+        }
+    });
+
+    torch::Tensor input = batch.to(device).permute({0, 3, 1, 2}).toType(torch::kFloat32).div(255).contiguous();
+
+    // 모델 추론: 모든 타일을 한 배치로, 또는 타일별로
+    torch::Tensor output;
+    torch::Tensor proto;
+    if (options.batchTiles) {
+        std::vector<torch::jit::IValue> inputs;
+        inputs.push_back(input);
+        output = splitModelOutput(model.forward(inputs), &proto);
+    } else {
+        std::vector<torch::Tensor> outputs;
+        std::vector<torch::Tensor> protos;
+        for (int i = 0; i < numTiles; ++i) {
+            std::vector<torch::jit::IValue> inputs;
+            inputs.push_back(input.slice(0, i, i + 1));
+            torch::Tensor tileProto;
+            outputs.push_back(splitModelOutput(model.forward(inputs), &tileProto));
+            if (tileProto.defined()) {
+                protos.push_back(tileProto);
+            }
+        }
+        output = torch::cat(outputs, 0);
+        if (!protos.empty()) {
+            proto = torch::cat(protos, 0);
+        }
+    }
+    int nm = proto.defined() ? static_cast<int>(proto.size(1)) : 0;
+
+    // 타일별 NMS를 병렬로 수행하고 박스를 원본 좌표로 이동
+    std::vector<std::vector<Detection>> tileDetections(numTiles);
+    cv::parallel_for_(cv::Range(0, numTiles), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            torch::Tensor prediction = output.slice(0, i, i + 1);
+            torch::Tensor keep = non_max_suppression(prediction, confThreshold, nmsThreshold, 300, nm)[0].to(torch::kCPU).contiguous();
+            auto rows = keep.accessor<float, 2>();
+            const cv::Rect valid(0, 0, tiles[i].width, tiles[i].height);
+            for (int k = 0; k < keep.size(0); ++k) {
+                cv::Rect box = cv::Rect(cv::Point(rows[k][0], rows[k][1]), cv::Point(rows[k][2], rows[k][3])) & valid;
+                if (box.empty()) {
+                    continue;
+                }
+                Detection detection;
+                detection.box = box + tiles[i].tl();
+                detection.confidence = rows[k][4];
+                detection.class_id = static_cast<int>(rows[k][5]);
+                if (nm > 0) {
+                    // 타일은 축소 없이 입력에 들어가므로 타일 좌표가 곧 입력 좌표
+                    detection.mask = std::make_shared<SegmentationMask>(
+                        keep[k].slice(0, 6, 6 + nm).clone(), proto[i],
+                        cv::Rect2f(box.x, box.y, box.width, box.height), cv::Size(tileSize, tileSize), detection.box);
+                }
+                tileDetections[i].push_back(detection);
+            }
+        }
+    });
+
+    // 타일 경계에서 잘린 박스를 잇고 겹침 영역의 중복을 제거
+    std::vector<Detection> candidates;
+    std::vector<int> tileIds;
+    for (int i = 0; i < numTiles; ++i) {
+        for (const auto& detection : tileDetections[i]) {
+            candidates.push_back(detection);
+            tileIds.push_back(i);
+        }
+    }
+    return merge_tile_detections(candidates, tileIds, tiles, frame.size(), nmsThreshold);
+}
+
+// 정책에 따른 탐지 함수
+std::vector<Detection> ObjectDetector::detect(const cv::Mat& frame, TilingPolicy& policy, const TilingOptions& options) {
+    bool tiled = policy.shouldTile(frame, options.tileSize);
+    std::vector<Detection> detections = tiled ? detectTiled(frame, options) : detect(frame);
+    policy.update(detections, tiled);
+    return detections;
+}
+
+// 봉투 단위 탐지 함수
+std::vector<Detection> ObjectDetector::detect(FrameEnvelope& frame, const StageDeadlines& deadlines) {
+    return detectStage(frame, deadlines, nullptr, TilingOptions());
+}
+
+std::vector<Detection> ObjectDetector::detect(FrameEnvelope& frame, const StageDeadlines& deadlines, TilingPolicy& policy, const TilingOptions& options) {
+    return detectStage(frame, deadlines, &policy, options);
+}
+
+std::vector<Detection> ObjectDetector::detectStage(FrameEnvelope& frame, const StageDeadlines& deadlines, TilingPolicy* policy, const TilingOptions& options) {
+    if (!deadlines.admit(frame, PipelineStage::INFERENCE)) {
+        return {};
+    }
+    std::vector<Detection> detections = policy != nullptr ? detect(frame.image, *policy, options) : detect(frame.image);
+    frame.endStage(PipelineStage::INFERENCE);
+    return detections;
+}
+
+bool ObjectDetector::supportsBatch(int batchSize) {
+    torch::NoGradGuard noGrad;
+    try {
+        torch::Tensor input = torch::zeros({batchSize, 3, 640, 640}, torch::TensorOptions().device(device));
+        torch::Tensor output = splitModelOutput(model.forward({input}), nullptr);
+        return output.size(0) == batchSize;
+    } catch (const std::exception&) {
+        // 정적 배치 모델은 추적된 reshape 등에서 실패함
+        return false;
+    }
+}
+
+bool TilingPolicy::shouldTile(const cv::Mat& frame, int tileSize) const {
+    // letterbox 축소 비율이 작으면 타일링해도 해상도 이득이 거의 없음
+    float gain = static_cast<float>(std::max(frame.cols, frame.rows)) / tileSize;
+    if (gain < minGain) {
+        return false;
+    }
+    return smallTargets || framesWithoutDetections >= probeInterval;
+}
+
+void TilingPolicy::update(const std::vector<Detection>& detections, bool tiled) {
+    smallTargets = false;
+    for (const auto& detection : detections) {
+        if (std::min(detection.box.width, detection.box.height) < smallObjectPx) {
+            smallTargets = true;
+            break;
+        }
+    }
+
+    if (!detections.empty()) {
+        framesWithoutDetections = 0;
+    } else if (tiled) {
+        // 탐색 결과 아무것도 없으면 다음 주기까지 전체 프레임 추론으로 복귀
+        framesWithoutDetections = 0;
+    } else {
+        ++framesWithoutDetections;
+    }
+}
@@ -5,6 +5,7 @@
 #include "CameraConstants.h"
 #include <iostream>
 #include <algorithm>
+#include <limits>
 #include <opencv2/opencv.hpp>
 
 // Function to calculate the distance to an object
@@ -34,8 +35,19 @@ cv::Mat undistortImage(const cv::Mat& distortedImage) {
     return undistortedImage;
 }
 
-// Function to process detections and calculate distances
-void calculateObjectDistances(const std::vector<Detection>& detections, cv::Mat& image) {
+// Function to measure the longer side of a mask's minimum-area rectangle (0 if the mask is empty)
+static float maskLongerSide(const cv::Mat& mask) {
+    std::vector<cv::Point> points;
+    cv::findNonZero(mask, points);
+    if (points.size() < 5) {
+        return 0.0f;
+    }
+    cv::RotatedRect rect = cv::minAreaRect(points);
+    return std::max(rect.size.width, rect.size.height);
+}
+
+// Function to estimate distances for a set of detections
+std::vector<ObjectDistance> estimateObjectDistances(const std::vector<Detection>& detections) {
     // Camera matrix and distortion coefficients
     cv::Mat cameraMatrix = (cv::Mat_<double>(3, 3) <<
         FOCAL_LENGTH_PX, 0, PRINCIPAL_POINT_X,
@@ -49,6 +61,9 @@ void calculateObjectDistances(const std::vector<Detection>& detections, cv::Mat&
         DISTORTION_COEFFS[3],
         DISTORTION_COEFFS[4]);
 
+    std::vector<ObjectDistance> objects;
+    objects.reserve(detections.size());
+
     // Iterate over each detection
     for (const auto& detection : detections) {
         // Extract bounding box corners
@@ -70,44 +85,99 @@ void calculateObjectDistances(const std::vector<Detection>& detections, cv::Mat&
         // Determine the longer side
         float longer_side_px = std::max(undistortedWidth, undistortedHeight);
 
+        // With a segmentation mask, measure the outline instead of the box: the box of a rotated
+        // parcel or an obliquely seen ring overstates the object's size. The mask is decoded here,
+        // on demand, and scaled by the box's undistortion ratio.
+        bool measured_from_mask = false;
+        if (detection.mask) {
+            float mask_side_px = maskLongerSide(detection.mask->get());
+            int box_side_px = std::max(detection.box.width, detection.box.height);
+            if (mask_side_px > 0.0f && box_side_px > 0) {
+                longer_side_px = mask_side_px * (longer_side_px / box_side_px);
+                measured_from_mask = true;
+            }
+        }
+
         // Variables for known dimension and label
+        ObjectDistance object;
+        object.detection = detection;
         float known_dimension = 0.0f;
-        std::string object_label;
 
         // Determine object type based on class ID
         if (detection.class_id == CLASS_ID_PARCEL) {
-            // For parcels, use width or height
+            // For parcels, use width or height. The mask's long side does not depend on how the
+            // parcel is rotated in the image, so it always corresponds to the parcel's long dimension.
             bool is_width_longer = (undistortedWidth >= undistortedHeight);
-            known_dimension = is_width_longer ? PARCEL_WIDTH : PARCEL_HEIGHT;
-            object_label = "Parcel";
+            if (measured_from_mask) {
+                known_dimension = std::max(PARCEL_WIDTH, PARCEL_HEIGHT);
+            } else {
+                known_dimension = is_width_longer ? PARCEL_WIDTH : PARCEL_HEIGHT;
+            }
+            object.label = "Parcel";
         } else if (detection.class_id == CLASS_ID_RING) {
             // For rings, use diameter
             known_dimension = PARCEL_DIAMETER;
-            object_label = "Ring";
+            object.label = "Ring";
         } else {
-            // Unknown object class
+            // Unknown object class: keep the entry so results stay aligned with the detections
             std::cerr << "Unknown class ID: " << detection.class_id << std::endl;
-            continue; // Skip this detection
+            object.label = "Unknown";
+            object.distanceCm = std::numeric_limits<float>::quiet_NaN();
+            objects.push_back(object);
+            continue;
         }
 
         // Choose appropriate focal length based on orientation
         float focal_length = (undistortedWidth >= undistortedHeight) ? FOCAL_LENGTH_PX : FOCAL_LENGTH_PY;
 
         // Calculate the distance
-        float distance = distanceToCamera(known_dimension, focal_length, longer_side_px);
+        object.distanceCm = distanceToCamera(known_dimension, focal_length, longer_side_px);
+        objects.push_back(object);
+    }
+
+    return objects;
+}
+
+// Function to print distance estimates and draw them on the image
+static void drawObjectDistances(const std::vector<ObjectDistance>& objects, cv::Mat& image) {
+    for (const auto& object : objects) {
+        if (!object.hasDistance()) {
+            continue;
+        }
+        const Detection& detection = object.detection;
 
         // Output results
-        std::cout << "Object: " << object_label
+        std::cout << "Object: " << object.label
                   << ", Class ID: " << detection.class_id
                   << ", Confidence: " << detection.confidence
-                  << ", Distance: " << distance << " cm" << std::endl;
+                  << ", Distance: " << object.distanceCm << " cm" << std::endl;
 
         // Draw bounding box on the original image
         cv::rectangle(image, detection.box, cv::Scalar(0, 255, 0), 2);
 
         // Display distance information
-        std::string label = object_label + ": " + std::to_string(static_cast<int>(distance)) + " cm";
+        std::string label = object.label + ": " + std::to_string(static_cast<int>(object.distanceCm)) + " cm";
         cv::putText(image, label, cv::Point(detection.box.x, detection.box.y - 10),
                     cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 0), 2);
     }
 }
+
+// Function to process detections and calculate distances
+void calculateObjectDistances(const std::vector<Detection>& detections, cv::Mat& image) {
+    drawObjectDistances(estimateObjectDistances(detections), image);
+}
+
+// Function to process a frame envelope, skipping frames that are already too old
+bool calculateObjectDistances(const std::vector<Detection>& detections, FrameEnvelope& frame, const StageDeadlines& deadlines, DistanceResult& result) {
+    if (!deadlines.admit(frame, PipelineStage::POSTPROCESS)) {
+        return false;
+    }
+
+    result.sequence = frame.sequence;
+    result.captureTimeNs = frame.captureTimeNs;
+    result.objects = estimateObjectDistances(detections);
+    result.resultTimeNs = monotonicNowNs();
+    drawObjectDistances(result.objects, frame.image);
+    frame.endStage(PipelineStage::POSTPROCESS);
+    return true;
+}
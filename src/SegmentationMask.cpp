@@ -0,0 +1,68 @@
+// src/SegmentationMask.cpp
+#include "SegmentationMask.h"
+#include <algorithm>
+#include <cmath>
+
+using torch::indexing::Slice;
+
+SegmentationMask::SegmentationMask(torch::Tensor coefficients, torch::Tensor proto, cv::Rect2f inputBox, cv::Size inputSize, cv::Rect frameBox)
+    : coefficients(std::move(coefficients)), proto(std::move(proto)), inputBox(inputBox), inputSize(inputSize), frameBox(frameBox) {}
+
+const cv::Mat& SegmentationMask::get() const {
+    std::call_once(decodeOnce, [this]() {
+        decode();
+        isDecoded.store(true, std::memory_order_release);
+    });
+    return mask;
+}
+
+bool SegmentationMask::decoded() const {
+    return isDecoded.load(std::memory_order_acquire);
+}
+
+void SegmentationMask::decode() const {
+    if (frameBox.width <= 0 || frameBox.height <= 0) {
+        mask = cv::Mat::zeros(std::max(frameBox.height, 1), std::max(frameBox.width, 1), CV_8UC1);
+        return;
+    }
+
+    // 입력 좌표의 박스를 프로토타입 해상도(실수 좌표)로 옮김
+    const int64_t nm = proto.size(0);
+    const int64_t ph = proto.size(1);
+    const int64_t pw = proto.size(2);
+    float sx = static_cast<float>(pw) / inputSize.width;
+    float sy = static_cast<float>(ph) / inputSize.height;
+    float fx1 = std::clamp(inputBox.x * sx, 0.0f, static_cast<float>(pw));
+    float fy1 = std::clamp(inputBox.y * sy, 0.0f, static_cast<float>(ph));
+    float fx2 = std::clamp((inputBox.x + inputBox.width) * sx, fx1, static_cast<float>(pw));
+    float fy2 = std::clamp((inputBox.y + inputBox.height) * sy, fy1, static_cast<float>(ph));
+    if (fx2 - fx1 <= 0.0f || fy2 - fy1 <= 0.0f) {
+        mask = cv::Mat::zeros(frameBox.size(), CV_8UC1);
+        return;
+    }
+
+    // 보간에 필요한 이웃 셀까지 포함해 정수 셀 단위로 잘라 디코딩
+    int64_t x1 = std::clamp<int64_t>(static_cast<int64_t>(std::floor(fx1 - 0.5f)), 0, pw - 1);
+    int64_t y1 = std::clamp<int64_t>(static_cast<int64_t>(std::floor(fy1 - 0.5f)), 0, ph - 1);
+    int64_t x2 = std::clamp<int64_t>(static_cast<int64_t>(std::ceil(fx2 + 0.5f)), x1 + 1, pw);
+    int64_t y2 = std::clamp<int64_t>(static_cast<int64_t>(std::ceil(fy2 + 0.5f)), y1 + 1, ph);
+
+    torch::NoGradGuard noGrad;
+    torch::Tensor crop = proto.index({Slice(), Slice(y1, y2), Slice(x1, x2)});
+    torch::Tensor coef = coefficients.to(proto.device(), proto.scalar_type()).view({1, nm});
+    torch::Tensor logits = torch::matmul(coef, crop.reshape({nm, -1}));
+    torch::Tensor probs = logits.sigmoid().view({y2 - y1, x2 - x1}).to(torch::kCPU).toType(torch::kFloat32).contiguous();
+
+    // 잘라낸 셀 격자를 확대하면서 박스의 실수 경계에 맞는 부분만 꺼냄 (셀 단위 반올림으로 인한 크기 오차 제거).
+    // 출력 픽셀 (u, v)의 중심은 프로토타입 좌표 fx1 + (u + 0.5) * (fx2 - fx1) / width에 해당하고,
+    // 셀 i의 중심은 i + 0.5이므로 crop 안의 샘플 위치는 그 값에서 x1 + 0.5를 뺀 것
+    cv::Mat cropMask(static_cast<int>(y2 - y1), static_cast<int>(x2 - x1), CV_32FC1, probs.data_ptr<float>());
+    double ax = (fx2 - fx1) / frameBox.width;
+    double ay = (fy2 - fy1) / frameBox.height;
+    cv::Matx23d toCrop(ax, 0.0, fx1 - x1 + 0.5 * ax - 0.5,
+                       0.0, ay, fy1 - y1 + 0.5 * ay - 0.5);
+    cv::Mat resized;
+    cv::warpAffine(cropMask, resized, toCrop, frameBox.size(), cv::INTER_LINEAR | cv::WARP_INVERSE_MAP, cv::BORDER_REPLICATE);
+    cv::threshold(resized, resized, 0.5, 255.0, cv::THRESH_BINARY);
+    resized.convertTo(mask, CV_8UC1);
+}
@@ -0,0 +1,232 @@
+// src/ThreadPolicy.cpp
+#include "ThreadPolicy.h"
+#include <opencv2/opencv.hpp>
+#include <torch/torch.h>
+#include <ATen/Parallel.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// 스레드별 상태: 마지막으로 적용한 정책과 진행 중인 단계의 측정 시작값
+struct ThreadState {
+    bool applied = false;
+    std::vector<int> appliedCpus;
+    int appliedPriority = 0;
+
+    int activeStage = -1;
+    long startVoluntary = 0;
+    long startInvoluntary = 0;
+    int startCpu = -1;
+    uint64_t startMigrations = 0;
+
+    int migrationFd = -2;  // -2: 아직 열지 않음, -1: perf 이벤트 사용 불가
+
+    ~ThreadState() {
+        if (migrationFd >= 0) {
+            close(migrationFd);
+        }
+    }
+};
+
+thread_local ThreadState t_state;
+
+// 스레드 단위 CPU 이동 카운터 (perf_event_paranoid 설정에 따라 실패할 수 있음)
+int openMigrationCounter() {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_SW_CPU_MIGRATIONS;
+    attr.exclude_hv = 1;
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return fd < 0 ? -1 : static_cast<int>(fd);
+}
+
+bool readMigrations(uint64_t& value) {
+    if (t_state.migrationFd == -2) {
+        t_state.migrationFd = openMigrationCounter();
+    }
+    if (t_state.migrationFd < 0) {
+        return false;
+    }
+    return read(t_state.migrationFd, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value));
+}
+
+void readCpuList(const cv::FileNode& node, std::vector<int>& cpus) {
+    cpus.clear();
+    if (node.empty()) {
+        return;
+    }
+    if (node.isSeq()) {
+        for (const auto& item : node) {
+            cpus.push_back(static_cast<int>(item));
+        }
+    } else {
+        cpus.push_back(static_cast<int>(node));
+    }
+}
+
+}  // namespace
+
+// 설정 파일 예:
+//   torch_threads: 3
+//   opencv_threads: 2
+//   capture: { cpus: [0], fifo_priority: 80 }
+//   inference: { cpus: [1, 2, 3], fifo_priority: 70 }
+//   postprocess: { cpus: [4] }
+SchedulingPolicy::SchedulingPolicy(const std::string& configPath) {
+    cv::FileStorage fs(configPath, cv::FileStorage::READ);
+    if (!fs.isOpened()) {
+        throw std::runtime_error("스케줄링 설정 파일을 열 수 없습니다: " + configPath);
+    }
+
+    if (!fs["torch_threads"].empty()) {
+        torchThreads = static_cast<int>(fs["torch_threads"]);
+    }
+    if (!fs["opencv_threads"].empty()) {
+        opencvThreads = static_cast<int>(fs["opencv_threads"]);
+    }
+
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        cv::FileNode node = fs[stageName(static_cast<PipelineStage>(i))];
+        if (node.empty()) {
+            continue;
+        }
+        readCpuList(node["cpus"], stages[i].cpus);
+        if (!node["fifo_priority"].empty()) {
+            stages[i].fifoPriority = static_cast<int>(node["fifo_priority"]);
+        }
+    }
+}
+
+void SchedulingPolicy::configureThreadPools() const {
+    // 지정하지 않으면 추론 단계에 할당된 코어 수에 맞춤 (전처리 resize 등도 추론 스레드에서 실행)
+    int inferenceCpus = static_cast<int>(stage(PipelineStage::INFERENCE).cpus.size());
+    int torchPool = torchThreads > 0 ? torchThreads : inferenceCpus;
+    int opencvPool = opencvThreads > 0 ? opencvThreads : inferenceCpus;
+    if (torchPool > 0) {
+        torch::set_num_threads(torchPool);
+    }
+    if (opencvPool > 0) {
+        cv::setNumThreads(opencvPool);
+    }
+
+    // set_num_threads/setNumThreads는 크기만 기록하고 작업자 스레드는 첫 병렬 구간에서 만들어진다.
+    // 빈 병렬 구간을 한 번씩 실행해 지금(이 스레드의 affinity와 우선순위로) 풀을 띄워 둠
+    int64_t torchWork = std::max(torchPool, 1) * 2;
+    at::parallel_for(0, torchWork, 1, [](int64_t, int64_t) {});
+    int opencvWork = std::max(opencvPool, 1) * 2;
+    cv::parallel_for_(cv::Range(0, opencvWork), [](const cv::Range&) {});
+}
+
+void SchedulingPolicy::apply(PipelineStage stage) const {
+    const StagePolicy& policy = stages[static_cast<int>(stage)];
+    if (t_state.applied && t_state.appliedCpus == policy.cpus && t_state.appliedPriority == policy.fifoPriority) {
+        return;
+    }
+
+    if (!policy.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : policy.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "Failed to pin " << stageName(stage) << " thread: " << std::strerror(errno) << std::endl;
+        }
+    }
+
+    // SCHED_FIFO는 CAP_SYS_NICE가 필요하므로 실패해도 기본 스케줄러로 계속 진행
+    struct sched_param param;
+    param.sched_priority = policy.fifoPriority;
+    int schedPolicy = policy.fifoPriority > 0 ? SCHED_FIFO : SCHED_OTHER;
+    if (policy.fifoPriority > 0 || t_state.appliedPriority > 0) {
+        if (pthread_setschedparam(pthread_self(), schedPolicy, &param) != 0) {
+            std::cerr << "Failed to set " << stageName(stage) << " scheduling priority " << policy.fifoPriority << std::endl;
+        }
+    }
+
+    t_state.applied = true;
+    t_state.appliedCpus = policy.cpus;
+    t_state.appliedPriority = policy.fifoPriority;
+}
+
+void SchedulingPolicy::bind(PipelineStage stage) {
+    apply(stage);
+}
+
+void SchedulingPolicy::enter(PipelineStage stage) {
+    if (t_state.activeStage >= 0) {
+        leave();
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    t_state.activeStage = static_cast<int>(stage);
+    t_state.startVoluntary = usage.ru_nvcsw;
+    t_state.startInvoluntary = usage.ru_nivcsw;
+    t_state.startCpu = sched_getcpu();
+    if (!readMigrations(t_state.startMigrations)) {
+        t_state.startMigrations = 0;
+    }
+}
+
+void SchedulingPolicy::leave() {
+    if (t_state.activeStage < 0) {
+        return;
+    }
+    Counters& c = counters[t_state.activeStage];
+    t_state.activeStage = -1;
+
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    c.entries.fetch_add(1, std::memory_order_relaxed);
+    c.voluntarySwitches.fetch_add(usage.ru_nvcsw - t_state.startVoluntary, std::memory_order_relaxed);
+    c.involuntarySwitches.fetch_add(usage.ru_nivcsw - t_state.startInvoluntary, std::memory_order_relaxed);
+
+    // perf 카운터를 쓸 수 없으면 시작/종료 시점의 코어만 비교 (중간 이동은 놓칠 수 있음)
+    uint64_t migrations = 0;
+    if (readMigrations(migrations)) {
+        c.migrations.fetch_add(migrations - t_state.startMigrations, std::memory_order_relaxed);
+    } else if (sched_getcpu() != t_state.startCpu) {
+        c.migrations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+StageStats SchedulingPolicy::stats(PipelineStage stage) const {
+    const Counters& c = counters[static_cast<int>(stage)];
+    StageStats s;
+    s.entries = c.entries.load(std::memory_order_relaxed);
+    s.voluntarySwitches = c.voluntarySwitches.load(std::memory_order_relaxed);
+    s.involuntarySwitches = c.involuntarySwitches.load(std::memory_order_relaxed);
+    s.migrations = c.migrations.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::string SchedulingPolicy::report() const {
+    std::ostringstream oss;
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        PipelineStage stage = static_cast<PipelineStage>(i);
+        StageStats s = stats(stage);
+        if (s.entries == 0) {
+            continue;
+        }
+        oss << stageName(stage)
+            << ": entries=" << s.entries
+            << ", voluntary cs/entry=" << static_cast<double>(s.voluntarySwitches) / s.entries
+            << ", involuntary cs/entry=" << static_cast<double>(s.involuntarySwitches) / s.entries
+            << ", migrations=" << s.migrations << "\n";
+    }
+    return oss.str();
+}
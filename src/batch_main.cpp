@@ -0,0 +1,99 @@
+#include "BatchProcessor.h"
+#include "ObjectDetector.h"
+#include <opencv2/opencv.hpp>
+#include <torch/torch.h>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Offline batch detection over recorded flights
+//   batch_detect <input dir|video> <output dir> [--model path] [--classes path] [--conf x]
+//                [--workers n] [--decoders n] [--overlays] [--mmap] [--cpu]
+// --mmap only takes effect with CPU inference: on CUDA the weights are copied to the GPU anyway
+// Writes <output dir>/detections.bin (columnar, see DetectionTable) and <output dir>/frames.csv,
+// plus <output dir>/overlays/*.jpg with --overlays
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input dir|video> <output dir> [--model path] [--classes path]"
+                  << " [--conf x] [--workers n] [--decoders n] [--overlays] [--mmap] [--cpu]" << std::endl;
+        std::cerr << "  --mmap  share the model weights through a read-only file mapping (CPU inference only)" << std::endl;
+        std::cerr << "  --cpu   run inference on the CPU even when CUDA is available" << std::endl;
+        return 1;
+    }
+
+    try {
+        std::string input = argv[1];
+        std::filesystem::path outputDir = argv[2];
+
+        std::string projectRoot = PROJECT_ROOT_DIR;
+        std::string modelPath = projectRoot + "/models/best_ringnParcel.torchscript";
+        std::string classNamesPath = projectRoot + "/models/parcel.txt";
+        float confThreshold = 0.5f;
+        BatchOptions options;
+        bool writeOverlays = false;
+        ModelLoadMode loadMode = ModelLoadMode::Copy;
+        torch::Device device = ObjectDetector::defaultDevice();
+
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--model" && hasValue) {
+                modelPath = argv[++i];
+            } else if (arg == "--classes" && hasValue) {
+                classNamesPath = argv[++i];
+            } else if (arg == "--conf" && hasValue) {
+                confThreshold = std::stof(argv[++i]);
+            } else if (arg == "--workers" && hasValue) {
+                options.workers = std::stoi(argv[++i]);
+            } else if (arg == "--decoders" && hasValue) {
+                options.decoders = std::stoi(argv[++i]);
+            } else if (arg == "--overlays") {
+                writeOverlays = true;
+            } else if (arg == "--mmap") {
+                // Every worker's detector then serves its weights from one shared file mapping
+                loadMode = ModelLoadMode::MemoryMapped;
+            } else if (arg == "--cpu") {
+                device = torch::Device(torch::kCPU);
+            } else {
+                throw std::runtime_error("Unknown argument: " + arg);
+            }
+        }
+
+        if (loadMode == ModelLoadMode::MemoryMapped && !device.is_cpu()) {
+            std::cerr << "--mmap has no effect on the CUDA path (weights are copied to the GPU); add --cpu to share them." << std::endl;
+        }
+
+        if (!std::filesystem::exists(modelPath)) {
+            throw std::runtime_error("Model file not found at " + modelPath);
+        }
+        std::filesystem::create_directories(outputDir);
+        if (writeOverlays) {
+            options.overlayDir = (outputDir / "overlays").string();
+        }
+
+        // Parallelism comes from one detector per worker; keep each forward pass single-threaded
+        // so the workers do not oversubscribe the cores through the libtorch/OpenCV pools
+        torch::set_num_threads(1);
+        cv::setNumThreads(1);
+
+        BatchProcessor processor([&]() {
+            auto detector = std::make_unique<ObjectDetector>(modelPath, classNamesPath, confThreshold, 0.4f, loadMode, device);
+            std::cout << detector->getLoadStats().report() << std::endl;
+            return detector;
+        }, options);
+
+        std::cout << "Processing " << input << "..." << std::endl;
+        DetectionTable table = processor.run(input);
+        table.save((outputDir / "detections.bin").string());
+        processor.saveManifest((outputDir / "frames.csv").string());
+
+        std::cout << processor.report() << std::endl;
+        std::cout << "Results written to " << outputDir.string() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
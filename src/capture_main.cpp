@@ -0,0 +1,83 @@
+#include "Camera.h"
+#include "CameraConstants.h"
+#include "FrameRing.h"
+#include "ThreadPolicy.h"
+#include <opencv2/opencv.hpp>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Capture process: owns the camera and publishes every frame into a shared-memory
+// ring so that detectors and other consumers can run in separate processes.
+//
+// Usage: capture_server [shm_name] [webcam] [--sched <path>]
+
+namespace {
+volatile std::sig_atomic_t g_running = 1;
+
+void handleSignal(int) {
+    g_running = 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> positional;
+    std::string schedPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--sched" && i + 1 < argc) {
+            schedPath = argv[++i];
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    std::string shmName = positional.size() > 0 ? positional[0] : "/drone_frames";
+    CameraType cameraType = (positional.size() > 1 && positional[1] == "webcam") ? CameraType::WEBCAM : CameraType::CSI;
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    try {
+        // Pin the capture thread (and the GStreamer threads it spawns) to the capture cores
+        std::unique_ptr<SchedulingPolicy> policy = schedPath.empty()
+            ? std::make_unique<SchedulingPolicy>()
+            : std::make_unique<SchedulingPolicy>(schedPath);
+        policy->bind(PipelineStage::CAPTURE);
+
+        std::cout << "Initializing camera..." << std::endl;
+        Camera camera(0, cameraType);
+
+        std::cout << "Creating frame ring " << shmName << "..." << std::endl;
+        FrameRing ring = FrameRing::create(shmName, SENSOR_RESOLUTION_X, SENSOR_RESOLUTION_Y, CV_8UC3);
+
+        while (g_running) {
+            // Capture straight into the next ring slot (the scope only measures; the thread stays pinned)
+            StageScope scope(*policy, PipelineStage::CAPTURE);
+            cv::Mat slot = ring.beginWrite();
+            cv::Mat frame = slot;
+            if (!camera.getFrame(frame)) {
+                std::cerr << "Received empty frame. Skipping." << std::endl;
+                continue;
+            }
+            int64_t timestampNs = monotonicNowNs();
+
+            // Some backends hand back their own buffer: fall back to a single copy
+            if (frame.data != slot.data) {
+                if (frame.size() != slot.size() || frame.type() != slot.type()) {
+                    std::cerr << "Frame format does not match the ring. Skipping." << std::endl;
+                    continue;
+                }
+                frame.copyTo(slot);
+            }
+            ring.publish(timestampNs);
+        }
+
+        std::cout << policy->report();
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
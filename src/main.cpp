@@ -2,15 +2,128 @@
 #include "ObjectDetector.h"
 #include "ObjectDistanceDetector.h"  // Include the distance calculation functions
 #include "CameraConstants.h"         // Include the camera constants
+#include "FrameRing.h"               // Shared-memory frame transport
+#include "ThreadPolicy.h"            // Per-stage CPU affinity and priorities
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <filesystem>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-int main() {
+namespace {
+
+// Frame handed from the capture thread to the inference thread. For the ring path the image
+// is a view into a ring slot, so the slot is kept to validate it after use.
+struct CapturedFrame {
+    FrameEnvelope frame;
+    SharedFrame shared;
+};
+
+// Frame handed from the inference thread to the postprocess (main) thread
+struct DetectedFrame {
+    FrameEnvelope frame;
+    std::vector<Detection> detections;
+};
+
+// Single-slot mailbox between two stage threads. put() replaces an item that has not been
+// taken yet, so a slow stage always works on the newest frame instead of a backlog.
+template <typename T>
+class LatestSlot {
+public:
+    void put(T item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (full) {
+                ++replaced;
+            }
+            value = std::move(item);
+            full = true;
+        }
+        ready.notify_one();
+    }
+
+    // Waits for an item; false once the producer has closed the slot
+    bool take(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this]() { return full || closed; });
+        if (!full) {
+            return false;
+        }
+        item = std::move(value);
+        full = false;
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+    uint64_t superseded() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return replaced;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable ready;
+    T value;
+    bool full = false;
+    bool closed = false;
+    uint64_t replaced = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
     try {
-        // Initialize camera
-        std::cout << "Initializing camera..." << std::endl;
-        Camera camera(0, CameraType::CSI);
+        // Frame source: the camera itself, or a shared-memory ring fed by capture_server (--shm <name>)
+        // Optional scheduling policy and stage deadline file (--sched <path>), see config/scheduling.yaml
+        std::string shmName;
+        std::string schedPath;
+        // --mmap: serve the model weights from a read-only file mapping shared with other processes.
+        // Only takes effect with CPU inference (--cpu); on CUDA the weights are copied to the GPU anyway.
+        ModelLoadMode loadMode = ModelLoadMode::Copy;
+        torch::Device device = ObjectDetector::defaultDevice();
+        // --tile: let TilingPolicy switch to tiled full-resolution inference while small targets are in view
+        bool tiling = false;
+        for (int i = 1; i < argc; ++i) {
+            if (std::string(argv[i]) == "--mmap") {
+                loadMode = ModelLoadMode::MemoryMapped;
+            } else if (std::string(argv[i]) == "--cpu") {
+                device = torch::Device(torch::kCPU);
+            } else if (std::string(argv[i]) == "--tile") {
+                tiling = true;
+            }
+        }
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::string(argv[i]) == "--shm") {
+                shmName = argv[i + 1];
+            } else if (std::string(argv[i]) == "--sched") {
+                schedPath = argv[i + 1];
+            }
+        }
+
+        // Each stage runs on its own thread, pinned once to that stage's cores (see SchedulingPolicy)
+        std::unique_ptr<SchedulingPolicy> policy = schedPath.empty()
+            ? std::make_unique<SchedulingPolicy>()
+            : std::make_unique<SchedulingPolicy>(schedPath);
+
+        // Frames older than a stage's deadline are dropped instead of processed
+        std::unique_ptr<StageDeadlines> deadlines = schedPath.empty()
+            ? std::make_unique<StageDeadlines>()
+            : std::make_unique<StageDeadlines>(schedPath);
+
+        std::unique_ptr<Camera> camera;
+        std::unique_ptr<FrameRing> ring;
 
         // Initialize ObjectDetector
         std::cout << "Initializing object detector..." << std::endl;
@@ -25,7 +138,11 @@ int main() {
             throw std::runtime_error("Class names file not found at " + class_names_path);
         }
 
-        ObjectDetector detector(model_path, class_names_path, 0.5f, 0.4f);
+        if (loadMode == ModelLoadMode::MemoryMapped && !device.is_cpu()) {
+            std::cerr << "--mmap has no effect on the CUDA path (weights are copied to the GPU); add --cpu to share them." << std::endl;
+        }
+        ObjectDetector detector(model_path, class_names_path, 0.5f, 0.4f, loadMode, device);
+        std::cout << detector.getLoadStats().report() << std::endl;
 
         // Set up camera matrix and distortion coefficients for undistortion
         cv::Mat cameraMatrix = (cv::Mat_<double>(3, 3) <<
@@ -47,31 +164,171 @@ int main() {
                                                                 cv::Size(SENSOR_RESOLUTION_X, SENSOR_RESOLUTION_Y),
                                                                 0);
 
-        while (true) {
+        std::atomic<bool> running{true};
+        LatestSlot<CapturedFrame> captured;
+        LatestSlot<DetectedFrame> detected;
+
+        // Capture thread: opens the source after pinning, so the camera backend's own threads
+        // (GStreamer) inherit the capture cores too
+        std::promise<void> captureReady;
+        std::thread captureThread([&]() {
+            policy->bind(PipelineStage::CAPTURE);
             try {
-                // Capture frame
-                cv::Mat frame = camera.getFrame();
+                if (shmName.empty()) {
+                    std::cout << "Initializing camera..." << std::endl;
+                    camera = std::make_unique<Camera>(0, CameraType::CSI);
+                } else {
+                    std::cout << "Attaching to frame ring " << shmName << "..." << std::endl;
+                    ring = std::make_unique<FrameRing>(FrameRing::open(shmName));
+                }
+                captureReady.set_value();
+            } catch (...) {
+                captureReady.set_exception(std::current_exception());
+                return;
+            }
 
-                if (frame.empty()) {
-                    std::cerr << "Received empty frame. Skipping." << std::endl;
-                    continue;
+            uint64_t lastSequence = 0;
+            // Kept across iterations so a frame dropped here leaves its buffer for the next read;
+            // a frame handed to inference is moved out and takes its buffer with it
+            CapturedFrame item;
+            while (running) {
+                try {
+                    // Capture frame (zero-copy view into the ring when attached to capture_server)
+                    StageScope scope(*policy, PipelineStage::CAPTURE);
+                    if (ring) {
+                        item.frame.reset();
+                        item.shared = SharedFrame();
+                        // Capture time on the ring path covers waiting for the producer and reading the slot
+                        item.frame.beginStage(PipelineStage::CAPTURE);
+                        if (!ring->waitForFrame(lastSequence, 1000) || !ring->readLatest(item.shared, lastSequence)) {
+                            std::cerr << "No new frame from " << shmName << ". Waiting." << std::endl;
+                            continue;
+                        }
+                        lastSequence = item.shared.sequence;
+                        item.frame.image = item.shared.image;
+                        item.frame.sequence = item.shared.sequence;
+                        item.frame.captureTimeNs = item.shared.timestampNs;
+                    } else if (!camera->capture(item.frame)) {
+                        std::cerr << "Received empty frame. Skipping." << std::endl;
+                        continue;
+                    }
+                    if (!deadlines->admit(item.frame, PipelineStage::CAPTURE)) {
+                        std::cerr << "Frame " << item.frame.sequence << " is already "
+                                  << item.frame.ageMs() << " ms old. Dropped." << std::endl;
+                        continue;
+                    }
+                    item.frame.endStage(PipelineStage::CAPTURE);
+
+                    // Only the newest frame waits for inference; an older one still waiting is superseded
+                    captured.put(std::move(item));
+                } catch (const std::exception& e) {
+                    std::cerr << "Error in capture loop: " << e.what() << std::endl;
                 }
+            }
+            captured.close();
+        });
+        try {
+            captureReady.get_future().get();
+        } catch (...) {
+            captureThread.join();
+            throw;
+        }
+
+        // Inference thread: pinned to the inference cores before any parallel region runs,
+        // so the libtorch/OpenCV pool workers are created there as well
+        std::thread inferenceThread([&]() {
+            policy->bind(PipelineStage::INFERENCE);
+            policy->configureThreadPools();
+
+            TilingPolicy tilingPolicy;
+            TilingOptions tilingOptions;
+            if (tiling) {
+                // Batched tiles need a dynamic-batch export; probe once here, after the pools are on the inference cores
+                tilingOptions.batchTiles = detector.supportsBatch(2);
+                std::cout << "Tiled inference: " << (tilingOptions.batchTiles ? "batched" : "one tile at a time (static-batch model)")
+                          << std::endl;
+            }
+            CapturedFrame item;
+            while (captured.take(item)) {
+                try {
+                    StageScope scope(*policy, PipelineStage::INFERENCE);
+                    FrameEnvelope& frame = item.frame;
 
-                // Undistort the frame
-                cv::Mat undistortedFrame;
-                cv::undistort(frame, undistortedFrame, cameraMatrix, distCoeffs, newCameraMatrix);
+                    // Undistortion counts towards inference, so check the deadline before spending time on it
+                    if (!deadlines->admit(frame, PipelineStage::INFERENCE)) {
+                        std::cerr << "Frame " << frame.sequence << " missed the inference deadline ("
+                                  << frame.ageMs() << " ms old). Dropped." << std::endl;
+                        continue;
+                    }
 
-                // Perform object detection on the undistorted frame
-                std::vector<Detection> detections = detector.detect(undistortedFrame);
+                    // Undistort the frame
+                    cv::Mat undistortedFrame;
+                    cv::undistort(frame.image, undistortedFrame, cameraMatrix, distCoeffs, newCameraMatrix);
+
+                    // Drop the frame if the producer overwrote the slot while we were reading it
+                    if (ring && !ring->isValid(item.shared)) {
+                        std::cerr << "Frame " << item.shared.sequence << " was overwritten. Skipping." << std::endl;
+                        continue;
+                    }
+                    frame.image = undistortedFrame;
+                    item.shared = SharedFrame();
+
+                    // Perform object detection on the undistorted frame
+                    DetectedFrame result;
+                    result.detections = tiling ? detector.detect(frame, *deadlines, tilingPolicy, tilingOptions)
+                                               : detector.detect(frame, *deadlines);
+                    if (frame.dropped) {
+                        std::cerr << "Frame " << frame.sequence << " missed the inference deadline ("
+                                  << frame.ageMs() << " ms old). Dropped." << std::endl;
+                        continue;
+                    }
+                    result.frame = std::move(frame);
+                    detected.put(std::move(result));
+                } catch (const std::exception& e) {
+                    std::cerr << "Error in inference loop: " << e.what() << std::endl;
+                }
+            }
+            detected.close();
+        });
+
+        // Postprocess on the main thread (HighGUI must stay on the thread that created the window)
+        policy->bind(PipelineStage::POSTPROCESS);
+        int frameCount = 0;
+        DetectedFrame item;
+        while (detected.take(item)) {
+            try {
+                StageScope scope(*policy, PipelineStage::POSTPROCESS);
+                FrameEnvelope& frame = item.frame;
 
                 // Calculate object distances and draw results
-                calculateObjectDistances(detections, undistortedFrame);
+                DistanceResult result;
+                if (!calculateObjectDistances(item.detections, frame, *deadlines, result)) {
+                    std::cerr << "Frame " << frame.sequence << " missed the postprocess deadline ("
+                              << frame.ageMs() << " ms old). Dropped." << std::endl;
+                    continue;
+                }
 
                 // Display the frame
-                cv::imshow("Object Detection", undistortedFrame);
+                cv::imshow("Object Detection", frame.image);
+                int key = cv::waitKey(1);
+
+                // Report per-stage context switches and migrations periodically
+                if (++frameCount % 300 == 0) {
+                    std::cout << policy->report();
+                    std::cout << "Frame " << result.sequence
+                              << ": glass-to-result " << result.latencyMs() << " ms"
+                              << " (capture " << frame.stageMs(PipelineStage::CAPTURE)
+                              << ", inference " << frame.stageMs(PipelineStage::INFERENCE)
+                              << ", postprocess " << frame.stageMs(PipelineStage::POSTPROCESS) << " ms)"
+                              << ", superseded before inference/postprocess: "
+                              << captured.superseded() << "/" << detected.superseded()
+                              << ", dropped at inference/postprocess: "
+                              << deadlines->droppedCount(PipelineStage::INFERENCE) << "/"
+                              << deadlines->droppedCount(PipelineStage::POSTPROCESS) << std::endl;
+                }
 
                 // Exit if 'q' is pressed
-                if (cv::waitKey(1) == 'q') {
+                if (key == 'q') {
                     break;
                 }
 
@@ -81,6 +338,10 @@ int main() {
                 continue;
             }
         }
+
+        running = false;
+        captureThread.join();
+        inferenceThread.join();
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
     }
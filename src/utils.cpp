@@ -1,6 +1,7 @@
 #include "utils.h"
 #include <torch/torch.h>
 #include <opencv2/opencv.hpp>
+#include <algorithm>
 #include <cmath>
 
 using torch::indexing::Slice;
@@ -47,16 +48,15 @@ float letterbox(const cv::Mat &input_image, cv::Mat &output_image, const std::ve
     cv::resize(input_image, output_image, cv::Size(new_shape_w, new_shape_h), 0, 0, cv::INTER_AREA);
 
     // 패딩을 추가 (만약 패딩이 전부 0일 경우, copyMakeBorder는 그대로 원본을 반환)
-    cv::copyMakeBorder(output_image, output_image, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(114.));
+    cv::copyMakeBorder(output_image, output_image, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(114, 114, 114));
 
     return resize_scale;
 }
 
 // non_max_suppression 함수 정의
-torch::Tensor non_max_suppression(torch::Tensor& prediction, float conf_thres, float iou_thres, int max_det) {
+torch::Tensor non_max_suppression(torch::Tensor& prediction, float conf_thres, float iou_thres, int max_det, int nm) {
     auto bs = prediction.size(0);
-    auto nc = prediction.size(1) - 4;
-    auto nm = prediction.size(1) - nc - 4;
+    auto nc = prediction.size(1) - 4 - nm;
     auto mi = 4 + nc;
     auto xc = prediction.index({torch::indexing::Slice(), torch::indexing::Slice(4, mi)}).amax(1) > conf_thres;
 
@@ -167,6 +167,148 @@ torch::Tensor scale_boxes(const std::vector<int>& img1_shape, torch::Tensor& box
     return boxes;
 }
 
+namespace {
+
+// 타일 병합용 박스: 어느 타일 내부 경계에 잘렸는지 표시 (left, top, right, bottom)
+struct TileBox {
+    Detection detection;
+    int tile;
+    bool cut[4];
+};
+
+int overlap_1d(int a0, int a1, int b0, int b1) {
+    return std::max(0, std::min(a1, b1) - std::max(a0, b0));
+}
+
+// 같은 객체가 두 타일에 걸쳐 반씩 잡혔는지 확인
+bool can_stitch(const TileBox& a, const TileBox& b, int seam_margin) {
+    const cv::Rect& ra = a.detection.box;
+    const cv::Rect& rb = b.detection.box;
+
+    // 좌우로 이어진 경우: 맞닿는 변이 모두 잘려 있고 세로 범위가 대부분 겹침
+    bool horizontal = (a.cut[2] && b.cut[0]) || (b.cut[2] && a.cut[0]);
+    if (horizontal &&
+        overlap_1d(ra.x - seam_margin, ra.x + ra.width + seam_margin, rb.x, rb.x + rb.width) > 0 &&
+        overlap_1d(ra.y, ra.y + ra.height, rb.y, rb.y + rb.height) >= 0.5f * std::min(ra.height, rb.height)) {
+        return true;
+    }
+
+    // 위아래로 이어진 경우
+    bool vertical = (a.cut[3] && b.cut[1]) || (b.cut[3] && a.cut[1]);
+    return vertical &&
+        overlap_1d(ra.y - seam_margin, ra.y + ra.height + seam_margin, rb.y, rb.y + rb.height) > 0 &&
+        overlap_1d(ra.x, ra.x + ra.width, rb.x, rb.x + rb.width) >= 0.5f * std::min(ra.width, rb.width);
+}
+
+TileBox stitch(const TileBox& a, const TileBox& b) {
+    TileBox merged;
+    const cv::Rect& ra = a.detection.box;
+    const cv::Rect& rb = b.detection.box;
+    merged.detection = a.detection;
+    merged.detection.box = ra | rb;
+    merged.detection.confidence = std::max(a.detection.confidence, b.detection.confidence);
+    merged.detection.mask.reset();  // 조각 마스크는 합친 박스와 맞지 않음
+    merged.tile = -1;  // 여러 타일에 걸친 박스
+
+    // 합친 박스의 각 변은 그 변을 이루는 원래 박스의 잘림 여부를 따름
+    const cv::Rect& r = merged.detection.box;
+    int edges_a[4] = {ra.x, ra.y, ra.x + ra.width, ra.y + ra.height};
+    int edges_b[4] = {rb.x, rb.y, rb.x + rb.width, rb.y + rb.height};
+    int edges[4] = {r.x, r.y, r.x + r.width, r.y + r.height};
+    for (int e = 0; e < 4; ++e) {
+        merged.cut[e] = (edges_a[e] == edges[e] && a.cut[e]) || (edges_b[e] == edges[e] && b.cut[e]);
+    }
+    return merged;
+}
+
+bool is_cut(const TileBox& box) {
+    return box.cut[0] || box.cut[1] || box.cut[2] || box.cut[3];
+}
+
+}  // namespace
+
+std::vector<Detection> merge_tile_detections(const std::vector<Detection>& detections, const std::vector<int>& tile_ids, const std::vector<cv::Rect>& tiles, const cv::Size& frame_size, float iou_thres, int seam_margin) {
+    // 박스가 프레임 가장자리가 아닌 타일 내부 경계에 닿아 있으면 잘린 것으로 표시
+    std::vector<TileBox> boxes;
+    boxes.reserve(detections.size());
+    for (size_t i = 0; i < detections.size(); ++i) {
+        const cv::Rect& t = tiles[tile_ids[i]];
+        const cv::Rect& b = detections[i].box;
+        TileBox box;
+        box.detection = detections[i];
+        box.tile = tile_ids[i];
+        box.cut[0] = t.x > 0 && b.x - t.x <= seam_margin;
+        box.cut[1] = t.y > 0 && b.y - t.y <= seam_margin;
+        box.cut[2] = t.x + t.width < frame_size.width && (t.x + t.width) - (b.x + b.width) <= seam_margin;
+        box.cut[3] = t.y + t.height < frame_size.height && (t.y + t.height) - (b.y + b.height) <= seam_margin;
+        boxes.push_back(box);
+    }
+
+    // 1단계: 타일 경계를 가로지르는 객체의 조각들을 하나로 연결
+    bool stitched = true;
+    while (stitched) {
+        stitched = false;
+        for (size_t i = 0; i < boxes.size() && !stitched; ++i) {
+            for (size_t j = i + 1; j < boxes.size(); ++j) {
+                if (boxes[i].detection.class_id != boxes[j].detection.class_id ||
+                    (boxes[i].tile >= 0 && boxes[i].tile == boxes[j].tile)) {
+                    continue;
+                }
+                if (can_stitch(boxes[i], boxes[j], seam_margin)) {
+                    boxes[i] = stitch(boxes[i], boxes[j]);
+                    boxes.erase(boxes.begin() + j);
+                    stitched = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // 2단계: 겹침 영역에서 중복된 박스 제거 (클래스별 NMS).
+    // 한 타일에서 잘린 조각은 다른 타일의 온전한 박스 안에 들어가므로 IoU와 함께
+    // 작은 박스 기준 겹침 비율도 보고, 이 경우에는 잘리지 않은 박스를 남긴다.
+    std::sort(boxes.begin(), boxes.end(), [](const TileBox& a, const TileBox& b) {
+        return a.detection.confidence > b.detection.confidence;
+    });
+
+    std::vector<TileBox> kept;
+    for (const auto& candidate : boxes) {
+        bool suppressed = false;
+        for (auto& k : kept) {
+            if (k.detection.class_id != candidate.detection.class_id) {
+                continue;
+            }
+            float inter = static_cast<float>((k.detection.box & candidate.detection.box).area());
+            if (inter <= 0.0f) {
+                continue;
+            }
+            float area_k = static_cast<float>(k.detection.box.area());
+            float area_c = static_cast<float>(candidate.detection.box.area());
+            float iou = inter / (area_k + area_c - inter);
+            float ios = inter / std::min(area_k, area_c);
+            if (iou > iou_thres || ios > 0.6f) {
+                if (is_cut(k) && !is_cut(candidate) && area_c > area_k) {
+                    float confidence = k.detection.confidence;
+                    k = candidate;
+                    k.detection.confidence = std::max(confidence, candidate.detection.confidence);
+                }
+                suppressed = true;
+                break;
+            }
+        }
+        if (!suppressed) {
+            kept.push_back(candidate);
+        }
+    }
+
+    std::vector<Detection> merged;
+    merged.reserve(kept.size());
+    for (const auto& k : kept) {
+        merged.push_back(k.detection);
+    }
+    return merged;
+}
+
 void draw_and_save_results(const cv::Mat& original_image, const std::vector<Detection>& detections, const std::vector<std::string>& class_names, const std::string& output_image_path) {
     cv::Mat image_with_boxes = original_image.clone();  // 원본 이미지를 복사하여 작업
     for (const auto& detection : detections) {
@@ -0,0 +1,74 @@
+// tests/SyntheticModel.h
+#ifndef SYNTHETIC_MODEL_H
+#define SYNTHETIC_MODEL_H
+
+#include <torch/script.h>
+#include <torch/torch.h>
+#include <string>
+#include <vector>
+
+// 실제 모델 파일 없이 파이프라인을 돌리기 위한 YOLOv8 형태의 합성 TorchScript 모듈.
+// 입력 [N, 3, 640, 640]에 대해 고정된 예측 [N, 4 + nc, 8400]을 반환하며,
+// 작은 합성곱 하나를 수행해 추론 비용이 0이 되지 않도록 한다.
+inline torch::jit::script::Module makeSyntheticYoloModule(int numClasses = 2, int numAnchors = 8400) {
+    torch::manual_seed(0);
+
+    torch::Tensor pred = torch::zeros({1, 4 + numClasses, numAnchors});
+    auto setBox = [&](int anchor, float cx, float cy, float w, float h, int classId, float score) {
+        pred[0][0][anchor] = cx;
+        pred[0][1][anchor] = cy;
+        pred[0][2][anchor] = w;
+        pred[0][3][anchor] = h;
+        pred[0][4 + classId][anchor] = score;
+    };
+
+    // 640x640 letterbox 좌표계 기준 (1280x720 입력이면 세로 140px 패딩)
+    setBox(100, 200.0f, 300.0f, 90.0f, 60.0f, 0, 0.90f);   // parcel
+    setBox(101, 204.0f, 302.0f, 88.0f, 58.0f, 0, 0.70f);   // NMS로 제거될 중복 parcel
+    setBox(200, 420.0f, 320.0f, 30.0f, 30.0f, 1, 0.80f);   // ring
+    setBox(300, 520.0f, 240.0f, 12.0f, 12.0f, 1, 0.30f);   // 임계값 미만
+
+    torch::jit::script::Module module("SyntheticYolo");
+    module.register_buffer("pred", pred);
+    module.register_parameter("weight", torch::randn({16, 3, 3, 3}), false);
+    module.define(R"JIT(
+def forward(self, x):
+    y = torch.conv2d(x, self.weight, None, [2, 2], [1, 1])
+    return self.pred.expand([x.size(0), -1, -1]) + y.mean() * 0.0
+)JIT");
+    return module;
+}
+
+// YOLOv8-seg 형태의 합성 모듈: (예측 [N, 4 + nc + 32, 8400], 프로토타입 [N, 32, 160, 160]) 튜플을 반환.
+// parcel 박스(입력 좌표 155..245 x 270..330)의 계수는 0번 프로토타입만 사용하며,
+// 0번 프로토타입은 박스의 왼쪽 절반에서만 양수라 디코딩된 마스크는 박스 왼쪽 절반을 덮는다.
+inline torch::jit::script::Module makeSyntheticSegModule(int numClasses = 2, int numAnchors = 8400) {
+    const int nm = 32;
+    torch::Tensor pred = torch::zeros({1, 4 + numClasses + nm, numAnchors});
+    pred[0][0][100] = 200.0f;
+    pred[0][1][100] = 300.0f;
+    pred[0][2][100] = 90.0f;
+    pred[0][3][100] = 60.0f;
+    pred[0][4][100] = 0.9f;
+    pred[0][4 + numClasses][100] = 1.0f;
+
+    // 프로토타입 해상도는 입력의 1/4
+    torch::Tensor proto = torch::full({1, nm, 160, 160}, -10.0f);
+    proto.index_put_({0, 0, torch::indexing::Slice(270 / 4, 330 / 4), torch::indexing::Slice(155 / 4, 200 / 4)}, 10.0f);
+
+    torch::jit::script::Module module("SyntheticYoloSeg");
+    module.register_buffer("pred", pred);
+    module.register_buffer("proto", proto);
+    module.define(R"JIT(
+def forward(self, x):
+    n = x.size(0)
+    return (self.pred.expand([n, -1, -1]) + x.mean() * 0.0, self.proto.expand([n, -1, -1, -1]))
+)JIT");
+    return module;
+}
+
+inline std::vector<std::string> syntheticClassNames() {
+    return {"parcel", "ring"};
+}
+
+#endif // SYNTHETIC_MODEL_H
@@ -0,0 +1,101 @@
+// tests/test_batch_processor.cpp
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include "BatchProcessor.h"
+#include "ObjectDistanceDetector.h"
+#include "SyntheticModel.h"
+
+namespace {
+
+const int kFrames = 12;
+
+// 합성 모델은 프레임마다 parcel, ring 하나씩을 내보냄
+std::filesystem::path writeFrames() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "drone_batch_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "input");
+    for (int i = 0; i < kFrames; ++i) {
+        cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(40, 60, 40 + i));
+        cv::imwrite((dir / "input" / cv::format("frame_%03d.png", i)).string(), frame);
+    }
+    return dir;
+}
+
+BatchProcessor::DetectorFactory syntheticFactory() {
+    return []() {
+        return std::make_unique<ObjectDetector>(makeSyntheticYoloModule(), syntheticClassNames(), 0.5f, 0.4f);
+    };
+}
+
+}  // namespace
+
+TEST(BatchProcessorTest, ProcessesDirectoryInFrameOrder) {
+    std::filesystem::path dir = writeFrames();
+
+    BatchOptions options;
+    options.workers = 3;
+    options.decoders = 2;
+    options.queueCapacity = 4;
+    options.overlayDir = (dir / "overlays").string();
+    BatchProcessor processor(syntheticFactory(), options);
+
+    DetectionTable table = processor.run((dir / "input").string());
+
+    EXPECT_EQ(processor.getStats().frames, static_cast<uint64_t>(kFrames));
+    EXPECT_EQ(processor.getStats().overlaysWritten, static_cast<uint64_t>(kFrames));
+    ASSERT_EQ(processor.getSources().size(), static_cast<size_t>(kFrames));
+    ASSERT_EQ(table.size(), static_cast<size_t>(kFrames * 2));
+    for (size_t i = 0; i < table.size(); ++i) {
+        EXPECT_EQ(table.frame[i], i / 2);
+        EXPECT_TRUE(std::isfinite(table.distanceCm[i]));
+    }
+
+    size_t overlays = std::distance(std::filesystem::directory_iterator(dir / "overlays"), std::filesystem::directory_iterator());
+    EXPECT_EQ(overlays, static_cast<size_t>(kFrames));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(BatchProcessorTest, ColumnarTableRoundTrips) {
+    DetectionTable table;
+    Detection parcel{cv::Rect(10, 20, 30, 40), 0.9f, 0, nullptr};
+    Detection unknown{cv::Rect(5, 6, 7, 8), 0.6f, 7, nullptr};
+    table.append(3, parcel, 120.5f);
+    table.append(1, unknown, std::nanf(""));
+    table.sortByFrame();
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "drone_batch_table.bin";
+    table.save(path.string());
+    DetectionTable loaded = DetectionTable::load(path.string());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(loaded.size(), 2u);
+    EXPECT_EQ(loaded.frame[0], 1u);
+    EXPECT_EQ(loaded.classId[0], 7);
+    EXPECT_TRUE(std::isnan(loaded.distanceCm[0]));
+    EXPECT_EQ(loaded.frame[1], 3u);
+    EXPECT_EQ(loaded.width[1], 30);
+    EXPECT_FLOAT_EQ(loaded.distanceCm[1], 120.5f);
+}
+
+TEST(BatchProcessorTest, UnknownClassKeepsItsSlot) {
+    std::vector<Detection> detections = {
+        {cv::Rect(100, 100, 80, 60), 0.9f, CLASS_ID_PARCEL, nullptr},
+        {cv::Rect(300, 200, 40, 40), 0.8f, 7, nullptr},  // 크기를 모르는 클래스
+        {cv::Rect(500, 300, 30, 30), 0.7f, CLASS_ID_RING, nullptr},
+    };
+
+    // 표의 행을 인덱스로 맞추므로 탐지마다 추정값이 같은 순서로 하나씩 있어야 함
+    std::vector<ObjectDistance> objects = estimateObjectDistances(detections);
+    ASSERT_EQ(objects.size(), detections.size());
+    EXPECT_TRUE(objects[0].hasDistance());
+    EXPECT_FALSE(objects[1].hasDistance());
+    EXPECT_EQ(objects[1].label, "Unknown");
+    EXPECT_EQ(objects[1].detection.box, detections[1].box);
+    EXPECT_TRUE(objects[2].hasDistance());
+    EXPECT_EQ(objects[2].label, "Ring");
+}
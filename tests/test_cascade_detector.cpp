@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include "CascadeDetector.h"
+#include "SyntheticModel.h"
+#include <memory>
+
+// 합성 모델 출력 (1280x720 프레임 기준): parcel 0.9, ring 0.8, 임계값 근처의 ring 0.3
+namespace {
+
+std::unique_ptr<ObjectDetector> makeDetector(float confThreshold) {
+    return std::make_unique<ObjectDetector>(makeSyntheticYoloModule(), syntheticClassNames(), confThreshold, 0.4f);
+}
+
+}  // namespace
+
+TEST(CascadeDetectorTest, RejectsUncertainDetectionsNotConfirmedByLargeModel) {
+    CascadeOptions options;
+    // 큰 모델은 아무것도 확인하지 않도록 임계값을 높게 설정
+    CascadeDetector cascade(makeDetector(options.candidateThreshold), makeDetector(0.95f), options);
+
+    cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 90, 90));
+    std::vector<Detection> detections = cascade.detect(frame);
+
+    // 확신도가 높은 parcel, ring만 남고 0.3짜리 후보는 버려짐
+    ASSERT_EQ(detections.size(), 2u);
+    for (const auto& detection : detections) {
+        EXPECT_GE(detection.confidence, options.acceptThreshold);
+    }
+
+    const CascadeStats& stats = cascade.getStats();
+    EXPECT_EQ(stats.frames, 1u);
+    EXPECT_EQ(stats.escalatedFrames, 1u);
+    EXPECT_EQ(stats.escalatedRegions, 1u);
+    EXPECT_EQ(stats.uncertainDetections, 1u);
+    EXPECT_EQ(stats.confirmedDetections, 0u);
+}
+
+TEST(CascadeDetectorTest, ConfidentFrameSkipsLargeModel) {
+    CascadeOptions options;
+    options.acceptThreshold = 0.25f;
+    CascadeDetector cascade(makeDetector(options.candidateThreshold), makeDetector(0.95f), options);
+
+    cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 90, 90));
+    cv::Mat original = frame.clone();
+    std::vector<Detection> detections = cascade.detect(frame);
+
+    EXPECT_EQ(detections.size(), 3u);
+    EXPECT_EQ(cascade.getStats().escalatedFrames, 0u);
+    EXPECT_DOUBLE_EQ(cascade.getStats().escalationRate(), 0.0);
+
+    // 탐지 과정에서 호출자의 프레임은 바뀌지 않아야 함
+    EXPECT_EQ(cv::norm(frame, original, cv::NORM_INF), 0.0);
+}
@@ -0,0 +1,94 @@
+// tests/test_frame.cpp
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <fstream>
+#include "Frame.h"
+
+TEST(FrameTest, FreshFrameIsAdmittedAndTimed) {
+    StageDeadlines deadlines;
+    deadlines.set(PipelineStage::INFERENCE, 50.0);
+
+    FrameEnvelope frame;
+    frame.sequence = 1;
+    frame.captureTimeNs = monotonicNowNs();
+
+    ASSERT_TRUE(deadlines.admit(frame, PipelineStage::INFERENCE));
+    EXPECT_FALSE(frame.dropped);
+    EXPECT_GT(frame.stageStartNs[static_cast<int>(PipelineStage::INFERENCE)], 0);
+
+    frame.endStage(PipelineStage::INFERENCE);
+    EXPECT_GE(frame.stageMs(PipelineStage::INFERENCE), 0.0);
+    EXPECT_GE(frame.ageMs(), 0.0);
+}
+
+TEST(FrameTest, StaleFrameIsDropped) {
+    StageDeadlines deadlines;
+    deadlines.set(PipelineStage::POSTPROCESS, 10.0);
+
+    // 100 ms 전에 캡처된 프레임
+    FrameEnvelope frame;
+    frame.sequence = 2;
+    frame.captureTimeNs = monotonicNowNs() - 100000000LL;
+
+    EXPECT_TRUE(deadlines.admit(frame, PipelineStage::INFERENCE)) << "마감 시간이 없는 단계는 항상 통과해야 합니다.";
+    EXPECT_FALSE(deadlines.admit(frame, PipelineStage::POSTPROCESS));
+    EXPECT_TRUE(frame.dropped);
+    EXPECT_EQ(frame.droppedAt, PipelineStage::POSTPROCESS);
+    EXPECT_EQ(deadlines.droppedCount(PipelineStage::POSTPROCESS), 1u);
+    EXPECT_EQ(frame.stageStartNs[static_cast<int>(PipelineStage::POSTPROCESS)], 0);
+
+    // 한 번 버려진 프레임은 이후 단계에서도 처리하지 않음
+    deadlines.set(PipelineStage::POSTPROCESS, 0.0);
+    EXPECT_FALSE(deadlines.admit(frame, PipelineStage::POSTPROCESS));
+}
+
+TEST(FrameTest, AdmitKeepsExistingStageStart) {
+    StageDeadlines deadlines;
+
+    // 캡처처럼 읽기 전에 단계를 시작한 프레임
+    FrameEnvelope frame;
+    frame.stageStartNs[static_cast<int>(PipelineStage::CAPTURE)] = 1;
+    frame.captureTimeNs = monotonicNowNs();
+
+    ASSERT_TRUE(deadlines.admit(frame, PipelineStage::CAPTURE));
+    EXPECT_EQ(frame.stageStartNs[static_cast<int>(PipelineStage::CAPTURE)], 1) << "이미 기록된 시작 시각을 덮어쓰면 안 됩니다.";
+}
+
+TEST(FrameTest, ResetKeepsImageBuffer) {
+    FrameEnvelope frame;
+    frame.image = cv::Mat(720, 1280, CV_8UC3);
+    frame.sequence = 3;
+    frame.captureTimeNs = monotonicNowNs();
+    frame.beginStage(PipelineStage::CAPTURE);
+    frame.dropped = true;
+    const uchar* buffer = frame.image.data;
+
+    frame.reset();
+    EXPECT_EQ(frame.image.data, buffer) << "캡처 버퍼가 재사용되지 않습니다.";
+    EXPECT_EQ(frame.sequence, 0u);
+    EXPECT_EQ(frame.captureTimeNs, 0);
+    EXPECT_EQ(frame.stageStartNs[static_cast<int>(PipelineStage::CAPTURE)], 0);
+    EXPECT_FALSE(frame.dropped);
+}
+
+TEST(FrameTest, LoadsDeadlinesFromConfig) {
+    std::filesystem::path configPath = std::filesystem::temp_directory_path() / "drone_deadline_test.yaml";
+    {
+        std::ofstream ofs(configPath);
+        ofs << "%YAML:1.0\n"
+            << "deadlines_ms:\n   inference: 60\n   postprocess: 120.5\n";
+    }
+
+    StageDeadlines deadlines(configPath.string());
+    std::filesystem::remove(configPath);
+
+    EXPECT_DOUBLE_EQ(deadlines.get(PipelineStage::CAPTURE), 0.0);
+    EXPECT_DOUBLE_EQ(deadlines.get(PipelineStage::INFERENCE), 60.0);
+    EXPECT_DOUBLE_EQ(deadlines.get(PipelineStage::POSTPROCESS), 120.5);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
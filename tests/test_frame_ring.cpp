@@ -0,0 +1,151 @@
+// tests/test_frame_ring.cpp
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "FrameRing.h"
+
+namespace {
+std::string uniqueRingName(const std::string& suffix) {
+    return "/drone_test_ring_" + std::to_string(getpid()) + "_" + suffix;
+}
+}  // namespace
+
+TEST(FrameRingTest, ReaderSeesFramesWithoutCopy) {
+    std::string name = uniqueRingName("basic");
+    FrameRing writer = FrameRing::create(name, 64, 48, CV_8UC3, 4);
+    FrameRing reader = FrameRing::open(name);
+
+    SharedFrame frame;
+    EXPECT_FALSE(reader.readLatest(frame)) << "게시 전에는 읽을 프레임이 없어야 합니다.";
+
+    cv::Mat image(48, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+    uint64_t sequence = writer.write(image, 1234);
+    EXPECT_EQ(sequence, 1u);
+
+    ASSERT_TRUE(reader.readLatest(frame));
+    EXPECT_EQ(frame.sequence, 1u);
+    EXPECT_EQ(frame.timestampNs, 1234);
+    EXPECT_EQ(frame.image.size(), image.size());
+    EXPECT_EQ(cv::norm(frame.image, image, cv::NORM_INF), 0.0);
+    EXPECT_TRUE(reader.isValid(frame));
+
+    // 슬롯 직접 쓰기 경로
+    cv::Mat slot = writer.beginWrite();
+    slot.setTo(cv::Scalar(1, 2, 3));
+    writer.publish(5678);
+
+    SharedFrame next;
+    ASSERT_TRUE(reader.readLatest(next, frame.sequence));
+    EXPECT_EQ(next.sequence, 2u);
+    EXPECT_EQ(next.image.at<cv::Vec3b>(0, 0), cv::Vec3b(1, 2, 3));
+    EXPECT_FALSE(reader.readLatest(next, next.sequence));
+}
+
+TEST(FrameRingTest, OverwrittenSlotIsDetected) {
+    std::string name = uniqueRingName("lap");
+    FrameRing writer = FrameRing::create(name, 16, 16, CV_8UC1, 2);
+    FrameRing reader = FrameRing::open(name);
+
+    cv::Mat image(16, 16, CV_8UC1, cv::Scalar(7));
+    writer.write(image, 1);
+
+    SharedFrame frame;
+    ASSERT_TRUE(reader.read(1, frame));
+
+    // 슬롯이 두 개뿐이므로 두 번 더 쓰면 첫 프레임 슬롯이 재사용됨
+    writer.write(image, 2);
+    writer.write(image, 3);
+    EXPECT_FALSE(reader.isValid(frame));
+    EXPECT_FALSE(reader.read(1, frame));
+    EXPECT_TRUE(reader.read(3, frame));
+}
+
+TEST(FrameRingTest, ConsumerInAnotherProcess) {
+    std::string name = uniqueRingName("fork");
+    FrameRing writer = FrameRing::create(name, 32, 32, CV_8UC1, 4);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // 자식 프로세스: 링을 열고 세 번째 프레임이 올 때까지 대기
+        FrameRing reader = FrameRing::open(name);
+        uint64_t last = 0;
+        while (last < 3) {
+            SharedFrame frame;
+            if (!reader.waitForFrame(last, 2000) || !reader.read(last + 1, frame)) {
+                _exit(1);
+            }
+            if (frame.image.at<unsigned char>(0, 0) != static_cast<unsigned char>(frame.sequence)) {
+                _exit(2);
+            }
+            last = frame.sequence;
+        }
+        _exit(0);
+    }
+
+    for (int i = 1; i <= 3; ++i) {
+        usleep(20000);
+        cv::Mat image(32, 32, CV_8UC1, cv::Scalar(i));
+        writer.write(image, monotonicNowNs());
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(FrameRingTest, LiveRingIsNotReplaced) {
+    std::string name = uniqueRingName("live");
+    FrameRing first = FrameRing::create(name, 16, 16, CV_8UC1, 2);
+    EXPECT_THROW(FrameRing::create(name, 16, 16, CV_8UC1, 2), std::runtime_error);
+
+    // 기존 링은 그대로 열림
+    FrameRing reader = FrameRing::open(name);
+    EXPECT_EQ(reader.width(), 16);
+}
+
+TEST(FrameRingTest, StaleRingIsReplaced) {
+    std::string name = uniqueRingName("stale");
+
+    // 링을 만든 뒤 정리 없이 종료한 캡처 프로세스
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        FrameRing ring = FrameRing::create(name, 16, 16, CV_8UC1, 2);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+
+    FrameRing ring = FrameRing::create(name, 16, 16, CV_8UC1, 2);
+    EXPECT_EQ(ring.width(), 16);
+}
+
+TEST(FrameRingTest, RingBeingInitializedIsNotRemoved) {
+    std::string name = uniqueRingName("init");
+
+    // 다른 프로세스가 ftruncate 직후 헤더를 아직 쓰지 않은 상태 (0으로 채워진 공유 메모리)
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, 4096), 0);
+    close(fd);
+
+    EXPECT_THROW(FrameRing::create(name, 16, 16, CV_8UC1, 2), std::runtime_error);
+    fd = shm_open(name.c_str(), O_RDONLY, 0);
+    EXPECT_GE(fd, 0) << "초기화 중인 링이 삭제되었습니다.";
+    if (fd >= 0) {
+        close(fd);
+    }
+    shm_unlink(name.c_str());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
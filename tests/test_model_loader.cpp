@@ -0,0 +1,119 @@
+// tests/test_model_loader.cpp
+#include <gtest/gtest.h>
+#include <torch/script.h>
+#include <torch/torch.h>
+#include <caffe2/serialize/inline_container.h>
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include "ModelLoader.h"
+#include "SyntheticModel.h"
+
+namespace {
+
+std::string saveSyntheticModel() {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "drone_synthetic_yolo.torchscript";
+    makeSyntheticYoloModule().save(path.string());
+    return path.string();
+}
+
+// 같은 모델을 .data/ts_code/ 레코드가 섞인 아카이브로 다시 씀 (torch.package로 묶인 모델의 배치)
+std::string savePackagedLayoutModel() {
+    std::string plain = saveSyntheticModel();
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "drone_synthetic_yolo_packaged.torchscript";
+    {
+        caffe2::serialize::PyTorchStreamReader reader(plain);
+        caffe2::serialize::PyTorchStreamWriter writer(path.string());
+        writer.setMinVersion(reader.version());
+        for (const auto& name : reader.getAllRecords()) {
+            // 버전/바이트 순서 레코드는 writer가 직접 씀
+            if (name == "version" || name == ".data/version" || name == "byteorder" || name == ".data/serialization_id") {
+                continue;
+            }
+            at::DataPtr data;
+            size_t size = 0;
+            std::tie(data, size) = reader.getRecord(name);
+            writer.writeRecord(name, data.get(), size);
+        }
+        const char marker[] = "#\n";
+        writer.writeRecord(".data/ts_code/code/__torch__/marker.py", marker, sizeof(marker) - 1);
+        writer.writeEndOfFile();
+    }
+    std::filesystem::remove(plain);
+    return path.string();
+}
+
+}  // namespace
+
+TEST(ModelLoaderTest, MappedWeightsMatchCopiedWeights) {
+    std::string path = saveSyntheticModel();
+    torch::Device cpu(torch::kCPU);
+
+    ModelLoadStats copyStats;
+    ModelLoadStats mappedStats;
+    torch::jit::script::Module copied = loadModel(path, cpu, ModelLoadMode::Copy, &copyStats);
+    torch::jit::script::Module mapped = loadModel(path, cpu, ModelLoadMode::MemoryMapped, &mappedStats);
+
+    EXPECT_EQ(copyStats.mode, ModelLoadMode::Copy);
+    EXPECT_EQ(mappedStats.mode, ModelLoadMode::MemoryMapped);
+    EXPECT_GT(mappedStats.mappedBytes, 0u);
+    // pred 버퍼(6 x 8400 float)와 합성곱 가중치가 모두 매핑으로 옮겨져야 함
+    EXPECT_GE(mappedStats.sharedBytes, 6u * 8400u * sizeof(float));
+    EXPECT_EQ(mappedStats.privateBytes, 0u);
+
+    torch::NoGradGuard noGrad;
+    torch::Tensor input = torch::rand({1, 3, 640, 640});
+    torch::Tensor expected = copied.forward({input}).toTensor();
+    torch::Tensor actual = mapped.forward({input}).toTensor();
+    EXPECT_TRUE(torch::equal(expected, actual));
+
+    std::filesystem::remove(path);
+}
+
+TEST(ModelLoaderTest, MappedModelsShareOneCopyOfWeights) {
+    std::string path = saveSyntheticModel();
+    torch::Device cpu(torch::kCPU);
+
+    torch::jit::script::Module first = loadModel(path, cpu, ModelLoadMode::MemoryMapped);
+    torch::jit::script::Module second = loadModel(path, cpu, ModelLoadMode::MemoryMapped);
+
+    // 같은 파일을 연 탐지기들은 같은 매핑 페이지를 가리킴
+    EXPECT_EQ(first.attr("pred").toTensor().data_ptr(), second.attr("pred").toTensor().data_ptr());
+    EXPECT_EQ(first.attr("weight").toTensor().data_ptr(), second.attr("weight").toTensor().data_ptr());
+
+    std::filesystem::remove(path);
+}
+
+TEST(ModelLoaderTest, MappingIsSkippedOffTheCpu) {
+    if (!torch::cuda::is_available()) {
+        GTEST_SKIP() << "CUDA를 사용할 수 없습니다.";
+    }
+    std::string path = saveSyntheticModel();
+
+    // GPU로 옮기는 모델은 매핑해도 공유되지 않으므로 Copy로 로드하고 그 사실을 기록
+    ModelLoadStats stats;
+    loadModel(path, torch::Device(torch::kCUDA), ModelLoadMode::MemoryMapped, &stats);
+    EXPECT_EQ(stats.mode, ModelLoadMode::Copy);
+    EXPECT_TRUE(stats.mappingSkipped);
+    EXPECT_NE(stats.report().find("mmap ignored"), std::string::npos);
+
+    std::filesystem::remove(path);
+}
+
+TEST(ModelLoaderTest, UnsupportedLayoutFallsBackToCopy) {
+    std::string path = savePackagedLayoutModel();
+    torch::Device cpu(torch::kCPU);
+
+    // 매핑 로더가 복원하지 않는 배치면 torch::jit::load로 로드하고 그 이유를 남김
+    ModelLoadStats stats;
+    torch::jit::script::Module module = loadModel(path, cpu, ModelLoadMode::MemoryMapped, &stats);
+    EXPECT_EQ(stats.mode, ModelLoadMode::Copy);
+    EXPECT_TRUE(stats.mappingSkipped);
+    EXPECT_EQ(stats.mappedBytes, 0u);
+    EXPECT_NE(stats.report().find(".data/ts_code/"), std::string::npos);
+
+    torch::NoGradGuard noGrad;
+    EXPECT_EQ(module.forward({torch::zeros({1, 3, 640, 640})}).toTensor().size(2), 8400);
+
+    std::filesystem::remove(path);
+}
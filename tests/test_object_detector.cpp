@@ -2,6 +2,7 @@
 #include <opencv2/opencv.hpp>
 #include "ObjectDetector.h"
 #include "utils.h"
+#include "SyntheticModel.h"
 #include <string>
 
 TEST(ObjectDetectorTest, DetectObjects) {
@@ -92,6 +93,133 @@ TEST(ObjectDetectorTest, DetectParcel) {
     draw_and_save_results(image, detections, detector.getClassNames(), "/output/detected_objects.jpg");
 }
 
+TEST(ObjectDetectorTest, LetterboxPadsEveryChannel) {
+    cv::Mat frame(320, 640, CV_8UC3, cv::Scalar(0, 0, 0));
+    cv::Mat padded;
+    letterbox(frame, padded, {640, 640});
+
+    ASSERT_EQ(padded.size(), cv::Size(640, 640));
+    // 채널 순서(BGR/RGB)와 관계없이 회색 여백이어야 함
+    EXPECT_EQ(padded.at<cv::Vec3b>(0, 0), cv::Vec3b(114, 114, 114));
+    EXPECT_EQ(padded.at<cv::Vec3b>(639, 639), cv::Vec3b(114, 114, 114));
+}
+
+TEST(ObjectDetectorTest, MergeStitchesBoxesCutAtTileSeam) {
+    // 1280x720 프레임, 가로로 겹치는 두 타일 (겹침 구간 x=512..640)
+    std::vector<cv::Rect> tiles = {cv::Rect(0, 0, 640, 640), cv::Rect(512, 0, 640, 640)};
+    cv::Size frameSize(1280, 720);
+
+    // 큰 객체가 두 타일에 걸쳐 잘린 조각 + 겹침 구간 안의 작은 객체 중복
+    std::vector<Detection> detections = {
+        {cv::Rect(400, 100, 240, 80), 0.8f, 0},   // 타일 0 오른쪽 경계에서 잘림
+        {cv::Rect(512, 102, 300, 78), 0.7f, 0},   // 타일 1 왼쪽 경계에서 잘림
+        {cv::Rect(560, 400, 20, 20), 0.9f, 1},    // 타일 0에서 본 작은 ring
+        {cv::Rect(561, 401, 19, 19), 0.85f, 1},   // 타일 1에서 본 같은 ring
+    };
+    std::vector<int> tileIds = {0, 1, 0, 1};
+
+    std::vector<Detection> merged = merge_tile_detections(detections, tileIds, tiles, frameSize, 0.45f);
+    ASSERT_EQ(merged.size(), 2u);
+
+    const Detection* parcel = merged[0].class_id == 0 ? &merged[0] : &merged[1];
+    EXPECT_EQ(parcel->box, cv::Rect(400, 100, 412, 80)) << "잘린 조각이 하나의 박스로 이어지지 않았습니다.";
+    EXPECT_FLOAT_EQ(parcel->confidence, 0.8f);
+}
+
+TEST(ObjectDetectorTest, TiledDetectionCoversNativeFrame) {
+    ObjectDetector detector(makeSyntheticYoloModule(), syntheticClassNames(), 0.5f, 0.4f);
+    cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(40, 60, 40));
+
+    std::vector<Detection> detections = detector.detectTiled(frame);
+    EXPECT_GT(detections.size(), 0) << "감지된 객체가 없습니다.";
+    for (const auto& det : detections) {
+        EXPECT_TRUE((det.box & cv::Rect(0, 0, frame.cols, frame.rows)) == det.box) << "박스가 프레임 밖에 있습니다.";
+    }
+
+    // 작은 객체가 보이면 다음 프레임부터 타일 추론으로 전환
+    TilingPolicy policy;
+    EXPECT_FALSE(policy.shouldTile(frame, 640));
+    policy.update({{cv::Rect(100, 100, 12, 12), 0.6f, 1}}, false);
+    EXPECT_TRUE(policy.shouldTile(frame, 640));
+    EXPECT_FALSE(policy.shouldTile(cv::Mat(640, 640, CV_8UC3), 640)) << "입력 크기 프레임은 타일링할 필요가 없습니다.";
+}
+
+TEST(ObjectDetectorTest, BoxesAreClampedToFrame) {
+    ObjectDetector detector(makeSyntheticYoloModule(), syntheticClassNames(), 0.5f, 0.4f);
+    // 640x1280 세로 프레임은 좌우에 160px 패딩이 붙어 parcel 박스(입력 x=155..245)가 왼쪽 패딩에 걸침
+    cv::Mat frame(1280, 640, CV_8UC3, cv::Scalar(40, 60, 40));
+
+    std::vector<Detection> detections = detector.detect(frame);
+    EXPECT_GT(detections.size(), 0) << "감지된 객체가 없습니다.";
+    for (const auto& det : detections) {
+        EXPECT_TRUE((det.box & cv::Rect(0, 0, frame.cols, frame.rows)) == det.box) << "박스가 프레임 밖에 있습니다.";
+    }
+
+    // 세그멘테이션 모델: 잘린 박스(프레임 x=0..170, 입력 x=160..245)의 마스크도 잘린 영역에 맞아야 함.
+    // 양수 프로토타입은 입력 x < 200까지이므로 마스크는 프레임 x < 80 (박스 왼쪽 80열)을 덮음
+    ObjectDetector segDetector(makeSyntheticSegModule(), syntheticClassNames(), 0.5f, 0.4f);
+    std::vector<Detection> segDetections = segDetector.detect(frame);
+    ASSERT_EQ(segDetections.size(), 1u);
+    const Detection& det = segDetections[0];
+    EXPECT_EQ(det.box.x, 0);
+    ASSERT_TRUE(det.mask != nullptr);
+    const cv::Mat& mask = det.mask->get();
+    ASSERT_EQ(mask.size(), det.box.size());
+    EXPECT_NEAR(cv::countNonZero(mask.row(mask.rows / 2)), 80, 2) << "잘린 박스의 마스크가 어긋났습니다.";
+}
+
+TEST(ObjectDetectorTest, SmallMaskKeepsSubCellBoundary) {
+    // 0번 프로토타입은 셀 10부터(입력 x >= 40) 양수
+    torch::Tensor proto = torch::full({1, 160, 160}, -10.0f);
+    proto.index_put_({0, torch::indexing::Slice(), torch::indexing::Slice(10, torch::indexing::None)}, 10.0f);
+
+    // 입력 x=38..46 (2셀, 셀 경계와 어긋남)을 16x16 프레임 박스로 확대: 경계는 입력 x=40, 즉 왼쪽에서 4열
+    SegmentationMask mask(torch::ones({1}), proto, cv::Rect2f(38.0f, 40.0f, 8.0f, 8.0f), cv::Size(640, 640), cv::Rect(0, 0, 16, 16));
+    const cv::Mat& m = mask.get();
+    ASSERT_EQ(m.size(), cv::Size(16, 16));
+    EXPECT_EQ(cv::countNonZero(m.row(8)), 12) << "셀 단위 반올림으로 마스크 크기가 틀어졌습니다.";
+    EXPECT_EQ(m.at<uchar>(8, 3), 0);
+    EXPECT_EQ(m.at<uchar>(8, 4), 255);
+}
+
+TEST(ObjectDetectorTest, TiledEnvelopeDetectionIsTimed) {
+    ObjectDetector detector(makeSyntheticYoloModule(), syntheticClassNames(), 0.5f, 0.4f);
+    EXPECT_TRUE(detector.supportsBatch(2)) << "합성 모델은 배치 크기와 무관하게 동작해야 합니다.";
+
+    FrameEnvelope frame;
+    frame.image = cv::Mat(720, 1280, CV_8UC3, cv::Scalar(40, 60, 40));
+    frame.captureTimeNs = monotonicNowNs();
+    StageDeadlines deadlines;
+    TilingPolicy policy;
+
+    std::vector<Detection> detections = detector.detect(frame, deadlines, policy);
+    EXPECT_GT(detections.size(), 0) << "감지된 객체가 없습니다.";
+    EXPECT_FALSE(frame.dropped);
+    EXPECT_GT(frame.stageEndNs[static_cast<int>(PipelineStage::INFERENCE)], 0) << "추론 단계 종료 시각이 기록되지 않았습니다.";
+}
+
+TEST(ObjectDetectorTest, SegmentationMaskIsDecodedLazily) {
+    ObjectDetector detector(makeSyntheticSegModule(), syntheticClassNames(), 0.5f, 0.4f);
+    cv::Mat frame(640, 640, CV_8UC3, cv::Scalar(40, 60, 40));
+
+    std::vector<Detection> detections = detector.detect(frame);
+    ASSERT_EQ(detections.size(), 1u);
+    const Detection& det = detections[0];
+    ASSERT_TRUE(det.mask != nullptr) << "세그멘테이션 모델인데 마스크가 없습니다.";
+    EXPECT_FALSE(det.mask->decoded()) << "마스크는 요청 전까지 디코딩되지 않아야 합니다.";
+
+    const cv::Mat& mask = det.mask->get();
+    EXPECT_TRUE(det.mask->decoded());
+    EXPECT_EQ(mask.size(), det.box.size());
+    EXPECT_EQ(mask.type(), CV_8UC1);
+
+    // 왼쪽 절반만 채워짐
+    double leftFill = cv::countNonZero(mask(cv::Rect(0, 0, mask.cols / 3, mask.rows))) / double(mask.cols / 3 * mask.rows);
+    double rightFill = cv::countNonZero(mask(cv::Rect(mask.cols * 2 / 3, 0, mask.cols - mask.cols * 2 / 3, mask.rows))) / double((mask.cols - mask.cols * 2 / 3) * mask.rows);
+    EXPECT_GT(leftFill, 0.9);
+    EXPECT_LT(rightFill, 0.1);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,296 @@
+// tests/test_pipeline_perf.cpp
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <torch/torch.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Camera.h"
+#include "ObjectDetector.h"
+#include "ObjectDistanceDetector.h"
+#include "SyntheticModel.h"
+
+// 프레임당 힙 할당 횟수 측정을 위해 malloc 계열 함수를 가로챔 (glibc).
+// 실행 파일에 정의한 심볼이 공유 라이브러리의 호출보다 우선하므로 C++ new뿐 아니라
+// libtorch 텐서 저장소와 cv::Mat 버퍼(posix_memalign/malloc)까지 모두 집계된다.
+static std::atomic<size_t> g_allocations{0};
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(size_t size) noexcept;
+void* __libc_calloc(size_t count, size_t size) noexcept;
+void* __libc_realloc(void* p, size_t size) noexcept;
+void* __libc_memalign(size_t alignment, size_t size) noexcept;
+
+void* malloc(size_t size) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) noexcept {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* p = memalign(alignment, size);
+    if (p == nullptr) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+}  // extern "C"
+#endif
+
+namespace {
+
+const int kReplayFrames = 60;
+const int kWarmupFrames = 5;
+
+struct PerfMetrics {
+    double fps = 0.0;
+    double p99LatencyMs = 0.0;
+    double allocsPerFrame = 0.0;
+};
+
+// 출력을 버리는 스트림 버퍼 (거리 계산 로그가 측정값에 섞이지 않도록)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// 움직이는 parcel/ring 모양을 그린 고정 프레임 시퀀스를 이미지 파일로 기록
+std::string writeReplaySequence(const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir);
+    for (int i = 0; i < kReplayFrames; ++i) {
+        cv::Mat frame(SENSOR_RESOLUTION_Y, SENSOR_RESOLUTION_X, CV_8UC3, cv::Scalar(40, 60, 40));
+        int shift = (i * 7) % 200;
+        cv::rectangle(frame, cv::Rect(300 + shift, 300, 180, 120), cv::Scalar(30, 120, 200), cv::FILLED);
+        cv::circle(frame, cv::Point(840 - shift, 360), 30, cv::Scalar(200, 200, 200), 6);
+        cv::imwrite((dir / cv::format("frame_%03d.png", i)).string(), frame);
+    }
+    return (dir / "frame_%03d.png").string();
+}
+
+// 캡처 -> 탐지 -> 거리 계산 전체 경로를 재생하며 지표를 측정
+PerfMetrics replayPipeline(const std::string& sequencePattern) {
+    Camera camera(sequencePattern);
+    ObjectDetector detector(makeSyntheticYoloModule(), syntheticClassNames(), 0.5f, 0.4f);
+
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    std::vector<double> latenciesMs;
+    latenciesMs.reserve(kReplayFrames);
+    size_t allocations = 0;
+    auto totalStart = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < kReplayFrames; ++i) {
+        if (i == kWarmupFrames) {
+            totalStart = std::chrono::steady_clock::now();
+        }
+        size_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+
+        cv::Mat frame = camera.getFrame();
+        if (frame.empty()) {
+            break;
+        }
+        std::vector<Detection> detections = detector.detect(frame);
+        calculateObjectDistances(detections, frame);
+
+        auto end = std::chrono::steady_clock::now();
+        if (i >= kWarmupFrames) {
+            latenciesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            allocations += g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+        }
+    }
+    auto totalEnd = std::chrono::steady_clock::now();
+    std::cout.rdbuf(coutBuffer);
+
+    PerfMetrics metrics;
+    if (latenciesMs.empty()) {
+        return metrics;
+    }
+    double totalSec = std::chrono::duration<double>(totalEnd - totalStart).count();
+    metrics.fps = latenciesMs.size() / totalSec;
+    metrics.allocsPerFrame = static_cast<double>(allocations) / latenciesMs.size();
+
+    std::sort(latenciesMs.begin(), latenciesMs.end());
+    size_t p99Index = static_cast<size_t>(std::ceil(0.99 * latenciesMs.size())) - 1;
+    metrics.p99LatencyMs = latenciesMs[std::min(p99Index, latenciesMs.size() - 1)];
+    return metrics;
+}
+
+// 벽시계 지표(FPS, p99)는 CPU 모델과 코어 수가 같은 기계의 기준선과만 비교함.
+// 호스트 이름은 CI 컨테이너마다 달라지므로 기계 식별에 쓰지 않는다.
+struct MachineInfo {
+    std::string cpu;
+    int cores = 0;
+
+    bool operator==(const MachineInfo& other) const { return cpu == other.cpu && cores == other.cores; }
+};
+
+MachineInfo currentMachine() {
+    MachineInfo machine;
+    // x86은 "model name", Jetson(aarch64)은 "Model" 항목에 CPU/보드 이름이 있음
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                machine.cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+                break;
+            }
+        }
+    }
+    machine.cores = static_cast<int>(std::thread::hardware_concurrency());
+    return machine;
+}
+
+// 기계별 벽시계 기준선
+struct MachineBaseline {
+    MachineInfo machine;
+    double fps = 0.0;
+    double p99LatencyMs = 0.0;
+};
+
+// 기준선 파일: 기계와 무관한 할당 횟수 기준선 하나 + 기계별 벽시계 기준선 목록
+struct Baseline {
+    double allocsPerFrame = 0.0;   // 0이면 아직 측정되지 않음
+    double allocsTolerance = 0.1;
+    double wallClockTolerance = 0.25;
+    std::vector<MachineBaseline> machines;
+};
+
+Baseline readBaseline(const std::string& path) {
+    Baseline baseline;
+    cv::FileStorage fs(path, cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+    if (!fs.isOpened()) {
+        throw std::runtime_error("기준선 파일을 열 수 없습니다: " + path);
+    }
+    cv::FileNode allocs = fs["allocs_per_frame"];
+    if (!allocs["baseline"].empty()) {
+        baseline.allocsPerFrame = static_cast<double>(allocs["baseline"]);
+    }
+    if (!allocs["tolerance"].empty()) {
+        baseline.allocsTolerance = static_cast<double>(allocs["tolerance"]);
+    }
+    if (!fs["wall_clock_tolerance"].empty()) {
+        baseline.wallClockTolerance = static_cast<double>(fs["wall_clock_tolerance"]);
+    }
+    for (const auto& node : fs["machines"]) {
+        MachineBaseline entry;
+        entry.machine.cpu = static_cast<std::string>(node["cpu"]);
+        entry.machine.cores = static_cast<int>(node["cores"]);
+        entry.fps = static_cast<double>(node["fps"]);
+        entry.p99LatencyMs = static_cast<double>(node["p99_latency_ms"]);
+        baseline.machines.push_back(entry);
+    }
+    return baseline;
+}
+
+void writeBaseline(const std::string& path, const Baseline& baseline) {
+    cv::FileStorage fs(path, cv::FileStorage::WRITE | cv::FileStorage::FORMAT_JSON);
+    fs << "allocs_per_frame" << "{" << "baseline" << baseline.allocsPerFrame << "tolerance" << baseline.allocsTolerance << "}";
+    fs << "wall_clock_tolerance" << baseline.wallClockTolerance;
+    fs << "machines" << "[";
+    for (const auto& entry : baseline.machines) {
+        fs << "{" << "cpu" << entry.machine.cpu << "cores" << entry.machine.cores
+           << "fps" << entry.fps << "p99_latency_ms" << entry.p99LatencyMs << "}";
+    }
+    fs << "]";
+}
+
+}  // namespace
+
+TEST(PipelinePerfTest, ReplayMatchesBaseline) {
+    std::string projectRoot = PROJECT_ROOT_DIR;
+    std::string baselinePath = projectRoot + "/tests/perf_baseline.json";
+
+    // 할당 횟수가 스레드 풀 크기(코어 수)에 따라 달라지지 않도록 단일 스레드로 측정
+    torch::set_num_threads(1);
+    cv::setNumThreads(1);
+
+    std::filesystem::path replayDir = std::filesystem::temp_directory_path() / "drone_perf_replay";
+    std::string pattern = writeReplaySequence(replayDir);
+
+    PerfMetrics metrics = replayPipeline(pattern);
+    std::filesystem::remove_all(replayDir);
+
+    std::cout << "FPS: " << metrics.fps
+              << ", p99 latency: " << metrics.p99LatencyMs << " ms"
+              << ", heap allocations/frame: " << metrics.allocsPerFrame << std::endl;
+    ASSERT_GT(metrics.fps, 0.0) << "재생된 프레임이 없습니다.";
+
+    Baseline baseline = readBaseline(baselinePath);
+    MachineInfo machine = currentMachine();
+    auto entry = std::find_if(baseline.machines.begin(), baseline.machines.end(),
+                              [&](const MachineBaseline& m) { return m.machine == machine; });
+
+    // PERF_UPDATE_BASELINE=1: 할당 기준선과 이 기계의 벽시계 기준선을 갱신 (다른 기계 항목은 유지)
+    const char* update = std::getenv("PERF_UPDATE_BASELINE");
+    if (update != nullptr && std::string(update) == "1") {
+        baseline.allocsPerFrame = metrics.allocsPerFrame;
+        if (entry == baseline.machines.end()) {
+            baseline.machines.push_back({machine});
+            entry = baseline.machines.end() - 1;
+        }
+        entry->fps = metrics.fps;
+        entry->p99LatencyMs = metrics.p99LatencyMs;
+        writeBaseline(baselinePath, baseline);
+        std::cout << "Baseline updated: " << baselinePath << std::endl;
+        return;
+    }
+
+    // 할당 횟수는 합성 모델과 라이브러리 버전에만 의존하므로 모든 기계에서 비교
+    ASSERT_GT(baseline.allocsPerFrame, 0.0)
+        << "할당 기준선이 측정되지 않았습니다. PERF_UPDATE_BASELINE=1로 실행해 " << baselinePath << "를 갱신하세요.";
+    EXPECT_LE(metrics.allocsPerFrame, baseline.allocsPerFrame * (1.0 + baseline.allocsTolerance))
+        << "Allocation regression (baseline " << baseline.allocsPerFrame << " per frame)";
+
+    // 처리량은 하한, 지연 시간은 상한으로 비교 (같은 CPU 모델/코어 수의 기준선이 있을 때만)
+    if (entry == baseline.machines.end()) {
+        std::cout << "No wall-clock baseline for " << machine.cpu << " (" << machine.cores
+                  << " cores); FPS and p99 latency are not checked." << std::endl;
+        return;
+    }
+    EXPECT_GE(metrics.fps, entry->fps * (1.0 - baseline.wallClockTolerance))
+        << "FPS regression (baseline " << entry->fps << ")";
+    EXPECT_LE(metrics.p99LatencyMs, entry->p99LatencyMs * (1.0 + baseline.wallClockTolerance))
+        << "p99 latency regression (baseline " << entry->p99LatencyMs << " ms)";
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
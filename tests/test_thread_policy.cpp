@@ -0,0 +1,75 @@
+// tests/test_thread_policy.cpp
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <sched.h>
+#include "ThreadPolicy.h"
+
+TEST(ThreadPolicyTest, LoadsStagePoliciesFromConfig) {
+    std::filesystem::path configPath = std::filesystem::temp_directory_path() / "drone_sched_test.yaml";
+    {
+        std::ofstream ofs(configPath);
+        ofs << "%YAML:1.0\n"
+            << "torch_threads: 2\n"
+            << "capture:\n   cpus: [ 0 ]\n   fifo_priority: 80\n"
+            << "inference:\n   cpus: [ 1, 2 ]\n";
+    }
+
+    SchedulingPolicy policy(configPath.string());
+    std::filesystem::remove(configPath);
+
+    EXPECT_EQ(policy.torchThreads, 2);
+    EXPECT_EQ(policy.opencvThreads, 0);
+    EXPECT_EQ(policy.stage(PipelineStage::CAPTURE).cpus, std::vector<int>({0}));
+    EXPECT_EQ(policy.stage(PipelineStage::CAPTURE).fifoPriority, 80);
+    EXPECT_EQ(policy.stage(PipelineStage::INFERENCE).cpus, std::vector<int>({1, 2}));
+    EXPECT_EQ(policy.stage(PipelineStage::INFERENCE).fifoPriority, 0);
+    EXPECT_TRUE(policy.stage(PipelineStage::POSTPROCESS).cpus.empty());
+}
+
+TEST(ThreadPolicyTest, PinsThreadAndCountsStages) {
+    // 러너의 cpuset에 CPU 0이 없을 수 있으므로 허용된 CPU 중 하나를 고름
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu = -1;
+    for (int i = 0; i < CPU_SETSIZE && cpu < 0; ++i) {
+        if (CPU_ISSET(i, &allowed)) {
+            cpu = i;
+        }
+    }
+    ASSERT_GE(cpu, 0);
+
+    SchedulingPolicy policy;
+    policy.stage(PipelineStage::POSTPROCESS).cpus = {cpu};
+
+    // 별도 스레드에서 실행해 테스트 프로세스의 다른 스레드 affinity에 영향을 주지 않음
+    std::thread worker([&policy, cpu]() {
+        policy.bind(PipelineStage::POSTPROCESS);
+        for (int i = 0; i < 3; ++i) {
+            StageScope scope(policy, PipelineStage::POSTPROCESS);
+            EXPECT_EQ(sched_getcpu(), cpu) << "후처리 스레드가 CPU " << cpu << "에 고정되지 않았습니다.";
+        }
+        // 단계 전환 시 이전 단계는 자동으로 종료되고, 고정된 코어는 바뀌지 않음
+        policy.enter(PipelineStage::CAPTURE);
+        policy.enter(PipelineStage::INFERENCE);
+        EXPECT_EQ(sched_getcpu(), cpu);
+        policy.leave();
+    });
+    worker.join();
+
+    EXPECT_EQ(policy.stats(PipelineStage::POSTPROCESS).entries, 3u);
+    EXPECT_EQ(policy.stats(PipelineStage::CAPTURE).entries, 1u);
+    EXPECT_EQ(policy.stats(PipelineStage::INFERENCE).entries, 1u);
+
+    std::string report = policy.report();
+    EXPECT_NE(report.find("postprocess"), std::string::npos);
+    EXPECT_NE(report.find("migrations="), std::string::npos);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}